@@ -79,6 +79,20 @@ CPM_BENCH() {
         [](std::size_t d){ return 2 * d; }, a, b);
 }
 
+//The threads of the parallel measures must not share the machine with other benchs
+CPM_EXCLUSIVE()
+CPM_BENCH() {
+    CPM_PARALLEL("parallel_a", [](std::size_t t){ std::this_thread::sleep_for((factor * (t + 1)) * 1_ns ); });
+    CPM_PARALLEL_P(VALUES_POLICY(1,2), "parallel_b", [](std::size_t /*t*/){ std::this_thread::sleep_for(factor * 10_ns ); });
+
+    CPM_PARALLEL_P(STRONG_SCALING_POLICY(1000, 4), "strong_a",
+        [](std::size_t /*t*/, std::size_t d, std::size_t threads){ std::this_thread::sleep_for((factor * (d / threads)) * 1_ns ); });
+    CPM_PARALLEL_P(WEAK_SCALING_POLICY(100, 4), "weak_a",
+        [](std::size_t /*t*/, std::size_t d, std::size_t threads){ std::this_thread::sleep_for((factor * (d / threads)) * 1_ns ); });
+    CPM_PARALLEL_P(NARY_POLICY(CONSTANT_POLICY(1000), THREADS_POLICY(4)), "strong_b",
+        [](std::size_t /*t*/, std::size_t d, std::size_t threads){ std::this_thread::sleep_for((factor * (d / threads)) * 1_ns ); });
+}
+
 CPM_BENCH() {
     CPM_TWO_PASS("2p_a",
         [](std::size_t d){ return std::make_tuple(test{d}); },
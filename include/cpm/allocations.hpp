@@ -0,0 +1,189 @@
+//=======================================================================
+// Copyright (c) 2015-2016 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef CPM_ALLOCATIONS_HPP
+#define CPM_ALLOCATIONS_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace cpm {
+
+//Heap operations of the current thread since its start
+struct allocation_counts {
+    std::size_t allocations;
+    std::size_t deallocations;
+    std::size_t bytes;
+
+    allocation_counts& operator+=(const allocation_counts& rhs){
+        allocations += rhs.allocations;
+        deallocations += rhs.deallocations;
+        bytes += rhs.bytes;
+        return *this;
+    }
+
+    allocation_counts operator-(const allocation_counts& rhs) const {
+        return {allocations - rhs.allocations, deallocations - rhs.deallocations, bytes - rhs.bytes};
+    }
+};
+
+//Heap operations per functor call of a measure
+struct allocation_result {
+    bool tracked = false; //Only when the tracker is linked and the measure timed its samples
+    double allocations = 0.0;
+    double deallocations = 0.0;
+    double bytes = 0.0;
+};
+
+//Constant initialization, the counters are used before any constructor runs
+inline constinit thread_local allocation_counts thread_allocations{0, 0, 0};
+
+//Set when the replacement functions are linked in the program
+inline bool allocation_tracker = false;
+
+inline allocation_counts allocation_snapshot(){
+    return thread_allocations;
+}
+
+inline void count_allocation(std::size_t size){
+    ++thread_allocations.allocations;
+    thread_allocations.bytes += size;
+}
+
+inline void count_deallocation(){
+    ++thread_allocations.deallocations;
+}
+
+} //end of namespace cpm
+
+//The tracker replaces the global allocation functions, it must be enabled
+//with CPM_TRACK_ALLOCATIONS in a single translation unit of the program
+//(the one of CPM_BENCHMARK). operator new and delete are always counted,
+//the malloc family only with the glibc, which exports the real functions
+
+#ifdef CPM_TRACK_ALLOCATIONS
+
+#ifdef __GLIBC__
+
+extern "C" {
+
+void* __libc_malloc(std::size_t size) noexcept;
+void* __libc_calloc(std::size_t count, std::size_t size) noexcept;
+void* __libc_realloc(void* ptr, std::size_t size) noexcept;
+void* __libc_memalign(std::size_t alignment, std::size_t size) noexcept;
+void __libc_free(void* ptr) noexcept;
+
+void* malloc(std::size_t size) noexcept {
+    cpm::count_allocation(size);
+    return __libc_malloc(size);
+}
+
+void* calloc(std::size_t count, std::size_t size) noexcept {
+    cpm::count_allocation(count * size);
+    return __libc_calloc(count, size);
+}
+
+//A realloc is counted as a new allocation and the release of the old one
+void* realloc(void* ptr, std::size_t size) noexcept {
+    if(ptr){
+        cpm::count_deallocation();
+    }
+
+    cpm::count_allocation(size);
+    return __libc_realloc(ptr, size);
+}
+
+void* aligned_alloc(std::size_t alignment, std::size_t size) noexcept {
+    cpm::count_allocation(size);
+    return __libc_memalign(alignment, size);
+}
+
+void* memalign(std::size_t alignment, std::size_t size) noexcept {
+    cpm::count_allocation(size);
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** ptr, std::size_t alignment, std::size_t size) noexcept {
+    if(alignment < sizeof(void*) || (alignment & (alignment - 1))){
+        return 22; //EINVAL
+    }
+
+    cpm::count_allocation(size);
+    *ptr = __libc_memalign(alignment, size);
+    return *ptr ? 0 : 12; //ENOMEM
+}
+
+void free(void* ptr) noexcept {
+    if(ptr){
+        cpm::count_deallocation();
+    }
+
+    __libc_free(ptr);
+}
+
+} //end of extern "C"
+
+#define CPM_RAW_MALLOC __libc_malloc
+#define CPM_RAW_FREE __libc_free
+
+#else
+
+#define CPM_RAW_MALLOC std::malloc
+#define CPM_RAW_FREE std::free
+
+#endif
+
+//The other forms (arrays, sizes, nothrow) are implemented by the standard
+//library with these ones, the aligned forms use the malloc family
+
+void* operator new(std::size_t size){
+    cpm::count_allocation(size);
+
+    if(auto ptr = CPM_RAW_MALLOC(size ? size : 1)){
+        return ptr;
+    }
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size){
+    return ::operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    if(ptr){
+        cpm::count_deallocation();
+    }
+
+    CPM_RAW_FREE(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    ::operator delete(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    ::operator delete(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    ::operator delete(ptr);
+}
+
+#undef CPM_RAW_MALLOC
+#undef CPM_RAW_FREE
+
+namespace {
+
+[[maybe_unused]] const bool cpm_allocation_tracker_linked = (cpm::allocation_tracker = true);
+
+} //end of anonymous namespace
+
+#endif //CPM_TRACK_ALLOCATIONS
+
+#endif //CPM_ALLOCATIONS_HPP
@@ -22,8 +22,8 @@ struct bootstrap_tabs_theme : bootstrap_theme {
 
     bootstrap_tabs_theme(const reports_data& data, cxxopts::Options& options, std::ostream& stream, std::string compiler, std::string configuration) : bootstrap_theme(data, options, stream, compiler, configuration) {}
 
-    void before_result(const std::string& title, bool sub, const std::vector<cpm::document_cref>& documents){
-        bootstrap_theme::before_result(title, sub, documents);
+    void before_result(const std::string& title, bool sub, const std::vector<cpm::document_cref>& documents, const std::vector<std::string>& extras){
+        bootstrap_theme::before_result(title, sub, documents, extras);
 
         stream << "<div class=\"col-xs-12\">\n";
         stream << "<div role=\"tabpanel\">\n";
@@ -64,6 +64,13 @@ struct bootstrap_tabs_theme : bootstrap_theme {
             ++tab_id;
         }
 
+        for(auto& extra : extras){
+            stream
+                << "<li role=\"presentation\"><a href=\"#tab_" << uid << '_' << tab_id << "\" aria-controls=\"tab_"
+                << uid << '_' << tab_id << "\" role=\"tab\" data-toggle=\"tab\">" << extra << "</a></li>\n";
+            ++tab_id;
+        }
+
         stream << "</ul>\n";
         stream << "<div class=\"tab-content\">\n";
 
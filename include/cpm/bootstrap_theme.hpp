@@ -21,6 +21,7 @@ struct bootstrap_theme {
     std::string current_configuration;
 
     std::size_t current_column = 0;
+    std::size_t extra_columns = 0;
 
     bootstrap_theme(const reports_data& data, cxxopts::Options& options, std::ostream& stream, std::string compiler, std::string configuration)
         : data(data), options(options), stream(stream), current_compiler(std::move(compiler)), current_configuration(std::move(configuration)) {}
@@ -226,6 +227,8 @@ struct bootstrap_theme {
             ++columns;
         }
 
+        columns += extra_columns;
+
         if(columns < 4){
             stream << "<div class=\"col-xs-" << 12 / columns << "\"" << style << ">\n";
         } else if(columns == 4){
@@ -248,6 +251,13 @@ struct bootstrap_theme {
             } else if(current_column == 4){
                 stream << "<div class=\"col-xs-8\"" << style << ">\n";
             }
+        } else {
+            if(current_column > 0 && current_column % 3 == 0){
+                stream << "</div>\n";
+                stream << "<div class=\"row\" style=\"display:flex; margin-top: 10px;\">\n";
+            }
+
+            stream << "<div class=\"col-xs-4\"" << style << ">\n";
         }
 
         ++current_column;
@@ -267,7 +277,7 @@ struct bootstrap_theme {
         close_column();
     }
 
-    void before_result(const std::string& title, bool sub, const std::vector<cpm::document_cref>& /*documents*/){
+    void before_result(const std::string& title, bool sub, const std::vector<cpm::document_cref>& /*documents*/, const std::vector<std::string>& extras){
         stream << "<div class=\"page-header\">\n";
         stream << "<h2>" << title << "</h2>\n";
         stream << "</div>\n";
@@ -279,6 +289,7 @@ struct bootstrap_theme {
         }
 
         current_column = 0;
+        extra_columns = extras.size();
     }
 
     void after_result(){
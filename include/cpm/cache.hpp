@@ -0,0 +1,109 @@
+//=======================================================================
+// Copyright (c) 2015-2016 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef CPM_CACHE_HPP
+#define CPM_CACHE_HPP
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+
+#include "config.hpp"
+
+namespace cpm {
+
+//Size in bytes of a cache described in sysfs ("32K", "8192K", "1M")
+inline std::size_t parse_cache_size(const std::string& size){
+    std::size_t value = 0;
+    std::size_t i = 0;
+
+    for(; i < size.size() && size[i] >= '0' && size[i] <= '9'; ++i){
+        value = value * 10 + (size[i] - '0');
+    }
+
+    if(i < size.size()){
+        if(size[i] == 'K'){
+            value *= 1024;
+        } else if(size[i] == 'M'){
+            value *= 1024 * 1024;
+        } else if(size[i] == 'G'){
+            value *= 1024 * 1024 * 1024;
+        }
+    }
+
+    return value;
+}
+
+//Size in bytes of the highest level data cache of the cpu, 0 if unknown
+inline std::size_t llc_size(int cpu){
+    std::size_t level = 0;
+    std::size_t size = 0;
+
+    for(std::size_t index = 0; ; ++index){
+        std::string folder = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cache/index" + std::to_string(index) + "/";
+
+        std::ifstream level_stream(folder + "level");
+
+        if(!level_stream){
+            break;
+        }
+
+        std::size_t current_level = 0;
+        level_stream >> current_level;
+
+        std::string type;
+        std::ifstream(folder + "type") >> type;
+
+        std::string current_size;
+        std::ifstream(folder + "size") >> current_size;
+
+        if(type != "Instruction" && current_level >= level){
+            level = current_level;
+            size = parse_cache_size(current_size);
+        }
+    }
+
+    return size;
+}
+
+//Sweeps a buffer larger than the last level cache so that the data of the
+//benchmark is evicted from all the levels before a cold sample
+struct cache_evictor {
+    void prepare(int cpu){
+        if(!buffer.empty()){
+            return;
+        }
+
+        auto llc = llc_size(std::max(0, cpu));
+
+        buffer.resize(llc ? static_cast<std::size_t>(llc * cpm::cold_cache_factor) : cpm::cold_cache_size);
+    }
+
+    //Every line is written so that dirty lines of the benchmark are written back too
+    void evict(){
+        static constexpr const std::size_t line = 64;
+
+        for(std::size_t i = 0; i < buffer.size(); i += line){
+            ++buffer[i];
+        }
+
+        //The sweep must not be optimized away
+        asm volatile("" : : "r"(buffer.data()) : "memory");
+    }
+
+    std::size_t size() const {
+        return buffer.size();
+    }
+
+private:
+    std::vector<unsigned char> buffer;
+};
+
+} //end of namespace cpm
+
+#endif //CPM_CACHE_HPP
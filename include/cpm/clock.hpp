@@ -0,0 +1,180 @@
+//=======================================================================
+// Copyright (c) 2015-2016 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef CPM_CLOCK_HPP
+#define CPM_CLOCK_HPP
+
+#include <cstdint>
+#include <cmath>
+
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#include <cpuid.h>
+#define CPM_HAS_TSC
+#endif
+
+#include "duration.hpp"
+
+namespace cpm {
+
+//A clock backend takes the time with start() and stop() and converts the
+//difference of two time points in nanoseconds with ns()
+
+//Clock based on std::chrono::steady_clock
+struct chrono_clock {
+    using time_point = timer_clock::time_point;
+
+    static const char* name(){
+        return "steady_clock";
+    }
+
+    static bool stable(){
+        return true;
+    }
+
+    static void calibrate(){}
+
+    static double frequency(){
+        return 0.0;
+    }
+
+    static time_point start(){
+        return timer_clock::now();
+    }
+
+    static time_point stop(){
+        return timer_clock::now();
+    }
+
+    static double ns(time_point start, time_point stop){
+        return std::chrono::duration_cast<nanoseconds>(stop - start).count();
+    }
+};
+
+//Clock directly based on clock_gettime(CLOCK_MONOTONIC_RAW), not adjusted by NTP
+struct raw_clock {
+    using time_point = uint64_t;
+
+    static const char* name(){
+        return "monotonic_raw";
+    }
+
+    static bool stable(){
+        return true;
+    }
+
+    static void calibrate(){}
+
+    static double frequency(){
+        return 0.0;
+    }
+
+    static time_point now(){
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+        return uint64_t(ts.tv_sec) * 1000UL * 1000UL * 1000UL + uint64_t(ts.tv_nsec);
+    }
+
+    static time_point start(){
+        return now();
+    }
+
+    static time_point stop(){
+        return now();
+    }
+
+    static double ns(time_point start, time_point stop){
+        return stop - start;
+    }
+};
+
+#ifdef CPM_HAS_TSC
+
+//Cycle clock based on the Time Stamp Counter
+//The reads are serialized so that the measured code cannot be reordered
+//outside of the timed region. The ticks are converted to nanoseconds with
+//the frequency computed by calibrate()
+struct tsc_clock {
+    using time_point = uint64_t;
+
+    static const char* name(){
+        return "tsc";
+    }
+
+    //Ticks per nanosecond (GHz)
+    static double& ticks_per_ns(){
+        static double ticks = 0.0;
+        return ticks;
+    }
+
+    static double frequency(){
+        return ticks_per_ns();
+    }
+
+    //Only an invariant TSC ticks at a constant rate, regardless of frequency scaling
+    static bool stable(){
+        unsigned int eax, ebx, ecx, edx;
+        if(__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)){
+            return edx & (1U << 8);
+        }
+
+        return false;
+    }
+
+    static void calibrate(){
+        if(ticks_per_ns() > 0.0){
+            return;
+        }
+
+        auto start_time = timer_clock::now();
+        auto start_tick = start();
+
+        while(timer_clock::now() - start_time < millseconds(50)){}
+
+        auto stop_tick = stop();
+        auto stop_time = timer_clock::now();
+
+        auto elapsed = std::chrono::duration_cast<nanoseconds>(stop_time - start_time).count();
+
+        ticks_per_ns() = static_cast<double>(stop_tick - start_tick) / elapsed;
+    }
+
+    static time_point start(){
+        _mm_lfence();
+        auto tick = __rdtsc();
+        _mm_lfence();
+        return tick;
+    }
+
+    static time_point stop(){
+        unsigned int aux;
+        auto tick = __rdtscp(&aux);
+        _mm_lfence();
+        return tick;
+    }
+
+    static double ns(time_point start, time_point stop){
+        return (stop - start) / ticks_per_ns();
+    }
+};
+
+#else
+
+//Without TSC, the cycle clock falls back to the raw monotonic clock
+using tsc_clock = raw_clock;
+
+#endif
+
+} //end of namespace cpm
+
+#ifndef CPM_CLOCK
+#define CPM_CLOCK cpm::chrono_clock
+#endif
+
+#endif //CPM_CLOCK_HPP
@@ -0,0 +1,653 @@
+//=======================================================================
+// Copyright (c) 2015-2016 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef CPM_COLUMNS_HPP
+#define CPM_COLUMNS_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <sstream>
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+#include <bit>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace cpm {
+
+//Results of a run in a binary columnar format, written as N.cpmb instead of
+//the JSON N.cpm. The document has the same tree as the JSON one, but each
+//array of objects is stored as a table (all the sizes of all the benchs are
+//in the same table for instance), with a column per member. The file is
+//little-endian and only made of fixed-size records, 8-byte aligned:
+//
+//  header                          64 bytes
+//  tables                          32 bytes each, the document is the first one
+//  columns                         32 bytes each, those of a table are contiguous
+//  cells of each column            8 bytes per row, then 1 byte per row (present)
+//  values of the arrays of numbers 8 bytes each
+//  strings                         terminated by a null character
+//
+//A cell is a number, a boolean, a string (offset and length in the strings)
+//or a range (first and count) of rows of a child table or of the numbers.
+//
+//The statistics of all the sizes of all the benchs are thus in the columns
+//of the "results/results" table (and "sections/results/results"), a value
+//of a run can be read without going through the rest of the document.
+
+static constexpr const char column_magic[8] = {'C', 'P', 'M', 'C', 'O', 'L', '\0', '\0'};
+static constexpr const uint32_t column_version = 1;
+
+enum class column_type : uint32_t {
+    INTEGER,
+    REAL,
+    BOOLEAN,
+    STRING,
+    REALS, //Array of numbers
+    TABLE  //Array of objects
+};
+
+struct column_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t tables;
+    uint64_t columns;
+    uint64_t index_offset; //tables then columns
+    uint64_t reals_offset;
+    uint64_t reals_count;
+    uint64_t strings_offset;
+    uint64_t strings_size;
+};
+
+struct column_table {
+    uint64_t name; //Path of the array in the document ("results/results")
+    uint64_t rows;
+    uint64_t first_column;
+    uint64_t columns;
+};
+
+struct column_entry {
+    uint64_t name;
+    column_type type;
+    uint32_t table; //Child table of a TABLE column
+    uint64_t cells_offset;
+    uint64_t present_offset;
+};
+
+static_assert(sizeof(column_header) == 64, "The layout of the results file is fixed");
+static_assert(sizeof(column_table) == 32, "The layout of the results file is fixed");
+static_assert(sizeof(column_entry) == 32, "The layout of the results file is fixed");
+
+inline uint64_t column_range(uint64_t first, uint64_t count){
+    return first | (count << 32);
+}
+
+//Builds the document in memory with the same calls as the JSON writer, it
+//can only be laid out in columns once it is complete
+struct column_writer {
+    struct node;
+
+    struct value {
+        column_type type = column_type::INTEGER;
+        int64_t integer = 0;
+        double real = 0.0;
+        std::string string;
+        std::vector<double> reals;
+        std::vector<node> nodes;
+    };
+
+    struct node {
+        std::vector<std::pair<std::string, value>> members;
+    };
+
+    column_writer(){
+        objects.push_back(&root);
+    }
+
+    void add(const std::string& tag, value v){
+        objects.back()->members.emplace_back(tag, std::move(v));
+    }
+
+    void start_array(const std::string& tag){
+        value v;
+        v.type = column_type::TABLE;
+        add(tag, std::move(v));
+        arrays.push_back(&objects.back()->members.back().second);
+    }
+
+    void close_array(){
+        arrays.pop_back();
+    }
+
+    void start_sub(){
+        arrays.back()->nodes.emplace_back();
+        objects.push_back(&arrays.back()->nodes.back());
+    }
+
+    void close_sub(){
+        objects.pop_back();
+    }
+
+    bool write(const std::string& file) const;
+
+private:
+    node root;
+    std::vector<node*> objects;
+    std::vector<value*> arrays;
+};
+
+template<typename T>
+inline void write_value(column_writer& writer, std::size_t& /*indent*/, const std::string& tag, const T& value, bool /*comma*/ = true){
+    std::ostringstream stream;
+    stream << value;
+
+    column_writer::value v;
+    v.type = column_type::STRING;
+    v.string = stream.str();
+    writer.add(tag, std::move(v));
+}
+
+inline void write_integer(column_writer& writer, const std::string& tag, int64_t value){
+    column_writer::value v;
+    v.type = column_type::INTEGER;
+    v.integer = value;
+    writer.add(tag, std::move(v));
+}
+
+template<>
+inline void write_value(column_writer& writer, std::size_t& /*indent*/, const std::string& tag, const std::size_t& value, bool /*comma*/){
+    write_integer(writer, tag, value);
+}
+
+template<>
+inline void write_value(column_writer& writer, std::size_t& /*indent*/, const std::string& tag, const int& value, bool /*comma*/){
+    write_integer(writer, tag, value);
+}
+
+template<>
+inline void write_value(column_writer& writer, std::size_t& /*indent*/, const std::string& tag, const int64_t& value, bool /*comma*/){
+    write_integer(writer, tag, value);
+}
+
+template<>
+inline void write_value(column_writer& writer, std::size_t& /*indent*/, const std::string& tag, const long long& value, bool /*comma*/){
+    write_integer(writer, tag, value);
+}
+
+template<>
+inline void write_value(column_writer& writer, std::size_t& /*indent*/, const std::string& tag, const bool& value, bool /*comma*/){
+    column_writer::value v;
+    v.type = column_type::BOOLEAN;
+    v.integer = value;
+    writer.add(tag, std::move(v));
+}
+
+template<>
+inline void write_value(column_writer& writer, std::size_t& /*indent*/, const std::string& tag, const double& value, bool /*comma*/){
+    column_writer::value v;
+    v.type = column_type::REAL;
+    v.real = value;
+    writer.add(tag, std::move(v));
+}
+
+template<typename T>
+inline void write_array(column_writer& writer, std::size_t& /*indent*/, const std::string& tag, const std::vector<T>& values, bool /*comma*/ = true){
+    column_writer::value v;
+    v.type = column_type::REALS;
+    v.reals.assign(values.begin(), values.end());
+    writer.add(tag, std::move(v));
+}
+
+inline void start_array(column_writer& writer, std::size_t& /*indent*/, const std::string& tag){
+    writer.start_array(tag);
+}
+
+inline void close_array(column_writer& writer, std::size_t& /*indent*/, bool /*comma*/){
+    writer.close_array();
+}
+
+inline void start_sub(column_writer& writer, std::size_t& /*indent*/){
+    writer.start_sub();
+}
+
+inline void close_sub(column_writer& writer, std::size_t& /*indent*/, bool /*comma*/){
+    writer.close_sub();
+}
+
+inline bool column_writer::write(const std::string& file) const {
+    //The records are written as they are in memory
+    if(std::endian::native != std::endian::little){
+        return false;
+    }
+
+    struct column_data {
+        std::string name;
+        column_type type;
+        uint32_t table = 0;
+        std::vector<uint64_t> cells;
+        std::vector<uint8_t> present;
+    };
+
+    struct table_data {
+        std::string name;
+        std::vector<const node*> rows;
+        std::vector<column_data> columns;
+    };
+
+    std::string strings;
+    std::map<std::string, uint64_t> string_index;
+
+    //The names of the members are repeated in each row, they are stored once
+    auto intern = [&](const std::string& s){
+        auto it = string_index.find(s);
+
+        if(it == string_index.end()){
+            it = string_index.emplace(s, column_range(strings.size(), s.size())).first;
+            strings += s;
+            strings += '\0';
+        }
+
+        return it->second;
+    };
+
+    std::vector<table_data> tables(1);
+    tables[0].rows.push_back(&root);
+
+    std::vector<double> reals;
+
+    //The rows of a table are all added by its parent table, before it is
+    //laid out itself, so the children of a row are contiguous
+    for(std::size_t t = 0; t < tables.size(); ++t){
+        for(std::size_t r = 0; r < tables[t].rows.size(); ++r){
+            for(auto& [name, v] : tables[t].rows[r]->members){
+                std::size_t c = 0;
+                while(c < tables[t].columns.size() && (tables[t].columns[c].name != name || tables[t].columns[c].type != v.type)){
+                    ++c;
+                }
+
+                if(c == tables[t].columns.size()){
+                    column_data column;
+                    column.name = name;
+                    column.type = v.type;
+                    column.cells.resize(tables[t].rows.size());
+                    column.present.resize(tables[t].rows.size());
+
+                    if(v.type == column_type::TABLE){
+                        column.table = tables.size();
+
+                        table_data child;
+                        child.name = tables[t].name.empty() ? name : tables[t].name + "/" + name;
+                        tables.push_back(std::move(child));
+                    }
+
+                    tables[t].columns.push_back(std::move(column));
+                }
+
+                auto& column = tables[t].columns[c];
+                uint64_t cell = 0;
+
+                switch(v.type){
+                    case column_type::INTEGER:
+                    case column_type::BOOLEAN:
+                        std::memcpy(&cell, &v.integer, sizeof(cell));
+                        break;
+                    case column_type::REAL:
+                        std::memcpy(&cell, &v.real, sizeof(cell));
+                        break;
+                    case column_type::STRING:
+                        cell = intern(v.string);
+                        break;
+                    case column_type::REALS:
+                        cell = column_range(reals.size(), v.reals.size());
+                        reals.insert(reals.end(), v.reals.begin(), v.reals.end());
+                        break;
+                    case column_type::TABLE:
+                        auto& child = tables[column.table];
+                        cell = column_range(child.rows.size(), v.nodes.size());
+                        for(auto& n : v.nodes){
+                            child.rows.push_back(&n);
+                        }
+                        break;
+                }
+
+                column.cells[r] = cell;
+                column.present[r] = 1;
+            }
+        }
+    }
+
+    //The ranges and the references to the strings are 32-bit
+    static constexpr const uint64_t range_max = 0xFFFFFFFF;
+
+    for(auto& table : tables){
+        if(table.rows.size() > range_max){
+            return false;
+        }
+    }
+
+    if(reals.size() > range_max){
+        return false;
+    }
+
+    std::size_t columns = 0;
+    for(auto& table : tables){
+        columns += table.columns.size();
+        intern(table.name);
+
+        for(auto& column : table.columns){
+            intern(column.name);
+        }
+    }
+
+    auto align = [](uint64_t offset){ return (offset + 7) & ~uint64_t(7); };
+
+    uint64_t offset = sizeof(column_header) + tables.size() * sizeof(column_table) + columns * sizeof(column_entry);
+
+    std::vector<column_table> table_entries;
+    std::vector<column_entry> column_entries;
+
+    for(auto& table : tables){
+        table_entries.push_back({intern(table.name), table.rows.size(), column_entries.size(), table.columns.size()});
+
+        for(auto& column : table.columns){
+            //The columns created after the first rows miss their cells
+            column.cells.resize(table.rows.size());
+            column.present.resize(table.rows.size());
+
+            column_entries.push_back({intern(column.name), column.type, column.table, offset, offset + column.cells.size() * sizeof(uint64_t)});
+            offset = align(offset + column.cells.size() * (sizeof(uint64_t) + 1));
+        }
+    }
+
+    column_header header;
+    std::memcpy(header.magic, column_magic, sizeof(header.magic));
+    header.version = column_version;
+    header.tables = tables.size();
+    header.columns = columns;
+    header.index_offset = sizeof(column_header);
+    header.reals_offset = offset;
+    header.reals_count = reals.size();
+    header.strings_offset = offset + reals.size() * sizeof(double);
+    header.strings_size = strings.size();
+
+    if(strings.size() > range_max){
+        return false;
+    }
+
+    std::ofstream stream(file, std::ios::binary);
+
+    if(!stream){
+        return false;
+    }
+
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    stream.write(reinterpret_cast<const char*>(table_entries.data()), table_entries.size() * sizeof(column_table));
+    stream.write(reinterpret_cast<const char*>(column_entries.data()), column_entries.size() * sizeof(column_entry));
+
+    static constexpr const char padding[8] = {};
+
+    for(auto& table : tables){
+        for(auto& column : table.columns){
+            stream.write(reinterpret_cast<const char*>(column.cells.data()), column.cells.size() * sizeof(uint64_t));
+            stream.write(reinterpret_cast<const char*>(column.present.data()), column.present.size());
+            stream.write(padding, align(column.present.size()) - column.present.size());
+        }
+    }
+
+    stream.write(reinterpret_cast<const char*>(reals.data()), reals.size() * sizeof(double));
+    stream.write(strings.data(), strings.size());
+
+    return static_cast<bool>(stream);
+}
+
+//Read-only mapping of a results file, nothing is parsed and the strings
+//can be used in place
+struct column_file {
+    column_file() = default;
+
+    column_file(const column_file&) = delete;
+    column_file& operator=(const column_file&) = delete;
+
+    ~column_file(){
+        close();
+    }
+
+    bool open(const std::string& file){
+        close();
+
+        if(std::endian::native != std::endian::little){
+            return false;
+        }
+
+        int fd = ::open(file.c_str(), O_RDONLY);
+
+        if(fd < 0){
+            return false;
+        }
+
+        struct stat buffer;
+        if(fstat(fd, &buffer) || std::size_t(buffer.st_size) < sizeof(column_header)){
+            ::close(fd);
+            return false;
+        }
+
+        length = buffer.st_size;
+        auto address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+
+        if(address == MAP_FAILED){
+            return false;
+        }
+
+        data = static_cast<const char*>(address);
+
+        if(!valid()){
+            close();
+            return false;
+        }
+
+        return true;
+    }
+
+    void close(){
+        if(data){
+            munmap(const_cast<char*>(data), length);
+            data = nullptr;
+            length = 0;
+        }
+    }
+
+    bool is_open() const {
+        return data;
+    }
+
+    std::size_t tables() const {
+        return header().tables;
+    }
+
+    std::string_view table_name(std::size_t t) const {
+        return string(table(t).name);
+    }
+
+    std::size_t rows(std::size_t t) const {
+        return table(t).rows;
+    }
+
+    std::size_t columns(std::size_t t) const {
+        return table(t).columns;
+    }
+
+    //The c-th column of the table t
+    const column_entry& column(std::size_t t, std::size_t c) const {
+        return entry(table(t).first_column + c);
+    }
+
+    std::string_view name(const column_entry& column) const {
+        return string(column.name);
+    }
+
+    bool present(const column_entry& column, std::size_t row) const {
+        return data[column.present_offset + row];
+    }
+
+    int64_t integer(const column_entry& column, std::size_t row) const {
+        return cell<int64_t>(column, row);
+    }
+
+    double real(const column_entry& column, std::size_t row) const {
+        return cell<double>(column, row);
+    }
+
+    bool boolean(const column_entry& column, std::size_t row) const {
+        return cell<int64_t>(column, row);
+    }
+
+    //Terminated by a null character in the mapping
+    std::string_view string(const column_entry& column, std::size_t row) const {
+        return string(cell<uint64_t>(column, row));
+    }
+
+    //First row in the child table and number of rows (TABLE), or first value
+    //and number of values (REALS)
+    std::pair<std::size_t, std::size_t> range(const column_entry& column, std::size_t row) const {
+        auto value = cell<uint64_t>(column, row);
+        return {value & 0xFFFFFFFF, value >> 32};
+    }
+
+    const double* reals() const {
+        return reinterpret_cast<const double*>(data + header().reals_offset);
+    }
+
+    //Column of the table t holding the member of the row, null if the row
+    //does not have it
+    const column_entry* find(std::size_t t, std::string_view member, std::size_t row) const {
+        for(std::size_t c = 0; c < columns(t); ++c){
+            auto& entry = column(t, c);
+
+            if(present(entry, row) && name(entry) == member){
+                return &entry;
+            }
+        }
+
+        return nullptr;
+    }
+
+private:
+    const column_header& header() const {
+        return *reinterpret_cast<const column_header*>(data);
+    }
+
+    const column_table& table(std::size_t t) const {
+        return reinterpret_cast<const column_table*>(data + header().index_offset)[t];
+    }
+
+    const column_entry& entry(std::size_t c) const {
+        return reinterpret_cast<const column_entry*>(data + header().index_offset + header().tables * sizeof(column_table))[c];
+    }
+
+    template<typename T>
+    T cell(const column_entry& column, std::size_t row) const {
+        T value;
+        std::memcpy(&value, data + column.cells_offset + row * sizeof(uint64_t), sizeof(value));
+        return value;
+    }
+
+    std::string_view string(uint64_t reference) const {
+        return {data + header().strings_offset + (reference & 0xFFFFFFFF), std::size_t(reference >> 32)};
+    }
+
+    //Check the bounds once so that the accessors do not have to
+    bool valid() const {
+        auto& h = header();
+
+        if(std::memcmp(h.magic, column_magic, sizeof(h.magic)) || h.version != column_version){
+            return false;
+        }
+
+        auto in = [this](uint64_t offset, uint64_t size){
+            return offset <= length && size <= length - offset;
+        };
+
+        if(!h.tables || h.index_offset % 8 || !in(h.index_offset, 0)
+            || h.tables > (length - h.index_offset) / sizeof(column_table)
+            || h.columns > (length - h.index_offset - h.tables * sizeof(column_table)) / sizeof(column_entry)){
+            return false;
+        }
+
+        if(h.reals_offset % 8 || !in(h.reals_offset, 0) || h.reals_count > (length - h.reals_offset) / sizeof(double) || !in(h.strings_offset, h.strings_size)){
+            return false;
+        }
+
+        //The strings are used as C strings
+        auto valid_string = [&h, this](uint64_t reference){
+            auto offset = reference & 0xFFFFFFFF;
+            auto size = reference >> 32;
+            return offset + size < h.strings_size && !data[h.strings_offset + offset + size];
+        };
+
+        if(rows(0) != 1){
+            return false;
+        }
+
+        for(std::size_t t = 0; t < h.tables; ++t){
+            auto& e = table(t);
+
+            if(!valid_string(e.name) || e.first_column > h.columns || e.columns > h.columns - e.first_column || e.rows > length){
+                return false;
+            }
+
+            for(std::size_t c = 0; c < e.columns; ++c){
+                auto& col = column(t, c);
+
+                if(!valid_string(col.name) || col.cells_offset % 8 || !in(col.cells_offset, e.rows * sizeof(uint64_t)) || !in(col.present_offset, e.rows)){
+                    return false;
+                }
+
+                if(uint32_t(col.type) > uint32_t(column_type::TABLE)){
+                    return false;
+                }
+
+                if(col.type == column_type::TABLE && (col.table <= t || col.table >= h.tables)){
+                    return false;
+                }
+
+                for(std::size_t r = 0; r < e.rows; ++r){
+                    if(!present(col, r)){
+                        continue;
+                    }
+
+                    if(col.type == column_type::STRING && !valid_string(cell<uint64_t>(col, r))){
+                        return false;
+                    }
+
+                    if(col.type == column_type::REALS && (range(col, r).first > h.reals_count || range(col, r).second > h.reals_count - range(col, r).first)){
+                        return false;
+                    }
+
+                    if(col.type == column_type::TABLE && (range(col, r).first > rows(col.table) || range(col, r).second > rows(col.table) - range(col, r).first)){
+                        return false;
+                    }
+                }
+            }
+        }
+
+        return true;
+    }
+
+    const char* data = nullptr;
+    std::size_t length = 0;
+};
+
+} //end of namespace cpm
+
+#endif //CPM_COLUMNS_HPP
@@ -22,6 +22,126 @@ static constexpr const double runtime_target = CPM_RUNTIME_TARGET; //seconds
 static constexpr const double runtime_target = 1.0; //seconds
 #endif
 
+#ifdef CPM_BATCH_TARGET
+static constexpr const double batch_target = CPM_BATCH_TARGET; //seconds
+#else
+static constexpr const double batch_target = 0.00001; //seconds
+#endif
+
+#ifdef CPM_UNRELIABLE_FACTOR
+static constexpr const double unreliable_factor = CPM_UNRELIABLE_FACTOR; //multiples of the clock resolution
+#else
+static constexpr const double unreliable_factor = 10.0; //multiples of the clock resolution
+#endif
+
+#ifdef CPM_CALIBRATION_STEPS
+static constexpr const std::size_t calibration_steps = CPM_CALIBRATION_STEPS;
+#else
+static constexpr const std::size_t calibration_steps = 1000;
+#endif
+
+#ifdef CPM_MONITOR_INTERVAL
+static constexpr const double monitor_interval = CPM_MONITOR_INTERVAL; //seconds
+#else
+static constexpr const double monitor_interval = 0.1; //seconds
+#endif
+
+#ifdef CPM_MONITOR_POINTS
+static constexpr const std::size_t monitor_points = CPM_MONITOR_POINTS; //samples saved per benchmark
+#else
+static constexpr const std::size_t monitor_points = 32; //samples saved per benchmark
+#endif
+
+#ifdef CPM_THROTTLE_RATIO
+static constexpr const double throttle_ratio = CPM_THROTTLE_RATIO; //fraction of the highest frequency
+#else
+static constexpr const double throttle_ratio = 0.9; //fraction of the highest frequency
+#endif
+
+#ifdef CPM_LOAD_THRESHOLD
+static constexpr const double load_threshold = CPM_LOAD_THRESHOLD; //percent of steal or iowait
+#else
+static constexpr const double load_threshold = 5.0; //percent of steal or iowait
+#endif
+
+#ifdef CPM_BOOTSTRAP_RESAMPLES
+static constexpr const std::size_t bootstrap_resamples = CPM_BOOTSTRAP_RESAMPLES; //0 for the normal approximation
+#else
+static constexpr const std::size_t bootstrap_resamples = 1000; //0 for the normal approximation
+#endif
+
+#ifdef CPM_BOOTSTRAP_SEED
+static constexpr const std::size_t bootstrap_seed = CPM_BOOTSTRAP_SEED;
+#else
+static constexpr const std::size_t bootstrap_seed = 42;
+#endif
+
+#ifdef CPM_PRECISION_MIN_STEPS
+static constexpr const std::size_t precision_min_steps = CPM_PRECISION_MIN_STEPS;
+#else
+static constexpr const std::size_t precision_min_steps = 10;
+#endif
+
+#ifdef CPM_PRECISION_MAX_STEPS
+static constexpr const std::size_t precision_max_steps = CPM_PRECISION_MAX_STEPS;
+#else
+static constexpr const std::size_t precision_max_steps = 100000;
+#endif
+
+#ifdef CPM_PRECISION_MAX_TIME
+static constexpr const double precision_max_time = CPM_PRECISION_MAX_TIME; //seconds per measure
+#else
+static constexpr const double precision_max_time = 10.0; //seconds per measure
+#endif
+
+#ifdef CPM_HISTOGRAM_DIGITS
+static constexpr const std::size_t histogram_digits = CPM_HISTOGRAM_DIGITS; //significant digits, 0 to disable
+#else
+static constexpr const std::size_t histogram_digits = 2; //significant digits, 0 to disable
+#endif
+
+#ifdef CPM_COLD_CACHE_FACTOR
+static constexpr const double cold_cache_factor = CPM_COLD_CACHE_FACTOR; //multiples of the last level cache swept before a cold sample
+#else
+static constexpr const double cold_cache_factor = 2.0; //multiples of the last level cache swept before a cold sample
+#endif
+
+#ifdef CPM_COLD_CACHE_SIZE
+static constexpr const std::size_t cold_cache_size = CPM_COLD_CACHE_SIZE; //bytes swept when the size of the cache is unknown
+#else
+static constexpr const std::size_t cold_cache_size = 64 * 1024 * 1024; //bytes swept when the size of the cache is unknown
+#endif
+
+#ifdef CPM_PEAK_STREAM_FACTOR
+static constexpr const double peak_stream_factor = CPM_PEAK_STREAM_FACTOR; //multiples of the last level cache in each array of the STREAM kernels
+#else
+static constexpr const double peak_stream_factor = 4.0; //multiples of the last level cache in each array of the STREAM kernels
+#endif
+
+#ifdef CPM_PEAK_STREAM_SIZE
+static constexpr const std::size_t peak_stream_size = CPM_PEAK_STREAM_SIZE; //bytes of each array when the size of the cache is unknown
+#else
+static constexpr const std::size_t peak_stream_size = 64 * 1024 * 1024; //bytes of each array when the size of the cache is unknown
+#endif
+
+#ifdef CPM_PEAK_STREAM_MAX
+static constexpr const std::size_t peak_stream_max = CPM_PEAK_STREAM_MAX; //maximum bytes of each array
+#else
+static constexpr const std::size_t peak_stream_max = 512 * 1024 * 1024; //maximum bytes of each array
+#endif
+
+#ifdef CPM_PEAK_REPEATS
+static constexpr const std::size_t peak_repeats = CPM_PEAK_REPEATS; //runs of each calibration kernel, the best one is kept
+#else
+static constexpr const std::size_t peak_repeats = 10; //runs of each calibration kernel, the best one is kept
+#endif
+
+#ifdef CPM_PEAK_FMA_ITERATIONS
+static constexpr const std::size_t peak_fma_iterations = CPM_PEAK_FMA_ITERATIONS; //iterations of the FMA kernels
+#else
+static constexpr const std::size_t peak_fma_iterations = 1 << 20; //iterations of the FMA kernels
+#endif
+
 } //end of namespace cpm
 
 #endif //CPM_CONFIG_HPP
@@ -0,0 +1,288 @@
+//=======================================================================
+// Copyright (c) 2015-2016 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef CPM_COUNTERS_HPP
+#define CPM_COUNTERS_HPP
+
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+namespace cpm {
+
+enum class counter_event : std::size_t {
+    CYCLES,
+    INSTRUCTIONS,
+    L1D_MISSES,
+    LLC_MISSES,
+    BRANCH_MISSES
+};
+
+static constexpr const std::size_t counter_events = 5;
+
+inline const char* counter_name(std::size_t event){
+    static constexpr const char* names[counter_events] = {"cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses"};
+    return names[event];
+}
+
+//Hardware counters of a measure, averaged per functor call
+//Counters that could not be opened on this machine are left invalid
+struct counters_result {
+    std::array<double, counter_events> values{};
+    std::array<bool, counter_events> valid{};
+
+    bool available() const {
+        for(auto v : valid){
+            if(v){
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool has(counter_event event) const {
+        return valid[std::size_t(event)];
+    }
+
+    double get(counter_event event) const {
+        return values[std::size_t(event)];
+    }
+
+    double ipc() const {
+        if(has(counter_event::CYCLES) && has(counter_event::INSTRUCTIONS) && get(counter_event::CYCLES) > 0.0){
+            return get(counter_event::INSTRUCTIONS) / get(counter_event::CYCLES);
+        }
+
+        return 0.0;
+    }
+};
+
+//Group of hardware counters read around each sample with perf_event_open
+//When perf events are not supported (other OS, perf_event_paranoid too strict,
+//no PMU in a VM, ...), the group is not available and only the time is measured
+struct perf_counters {
+    perf_counters(){
+        fds.fill(-1);
+        totals.fill(0.0);
+    }
+
+    perf_counters(const perf_counters&) = delete;
+    perf_counters& operator=(const perf_counters&) = delete;
+
+    ~perf_counters(){
+        reset();
+    }
+
+    //Close the events, they will be opened again by the next call to open()
+    //This is necessary in a forked process, the events count the process that opened them
+    void reset(){
+#ifdef __linux__
+        for(auto fd : fds){
+            if(fd >= 0){
+                ::close(fd);
+            }
+        }
+#endif
+
+        fds.fill(-1);
+        totals.fill(0.0);
+        overhead.fill(0.0);
+        enabled = 0;
+        running = 0;
+        calibrated = false;
+        tried = false;
+        leader = -1;
+        active = 0;
+    }
+
+    //Only the first call tries to open the events
+    bool open(){
+        if(tried){
+            return available();
+        }
+
+        tried = true;
+
+#ifdef __linux__
+        for(std::size_t i = 0; i < counter_events; ++i){
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+
+            attr.size           = sizeof(attr);
+            attr.disabled       = leader < 0 ? 1 : 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv     = 1;
+            attr.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            switch(counter_event(i)){
+                case counter_event::CYCLES:
+                    attr.type   = PERF_TYPE_HARDWARE;
+                    attr.config = PERF_COUNT_HW_CPU_CYCLES;
+                    break;
+                case counter_event::INSTRUCTIONS:
+                    attr.type   = PERF_TYPE_HARDWARE;
+                    attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+                    break;
+                case counter_event::L1D_MISSES:
+                    attr.type   = PERF_TYPE_HW_CACHE;
+                    attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+                    break;
+                case counter_event::LLC_MISSES:
+                    attr.type   = PERF_TYPE_HARDWARE;
+                    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+                    break;
+                case counter_event::BRANCH_MISSES:
+                    attr.type   = PERF_TYPE_HARDWARE;
+                    attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+                    break;
+            }
+
+            int fd = syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0);
+
+            if(fd < 0){
+                continue;
+            }
+
+            if(leader < 0){
+                leader = fd;
+            }
+
+            fds[i]   = fd;
+            slots[i] = active++;
+        }
+#endif
+
+        return available();
+    }
+
+    bool available() const {
+        return leader >= 0;
+    }
+
+    void clear(){
+        totals.fill(0.0);
+    }
+
+    void start(){
+#ifdef __linux__
+        ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    void stop(){
+        auto values = read_sample();
+
+        for(std::size_t i = 0; i < counter_events; ++i){
+            totals[i] += std::max(0.0, values[i] - overhead[i]);
+        }
+    }
+
+    //Counts of an empty sample (the reads of the clock in the counted region),
+    //subtracted from each sample. The group is only calibrated once
+    template<typename Empty>
+    void calibrate(Empty empty){
+        if(calibrated){
+            return;
+        }
+
+        calibrated = true;
+
+        std::vector<std::array<double, counter_events>> samples(100);
+
+        for(auto& sample : samples){
+            start();
+            empty();
+            sample = read_sample();
+        }
+
+        for(std::size_t i = 0; i < counter_events; ++i){
+            std::vector<double> values;
+
+            for(auto& sample : samples){
+                values.push_back(sample[i]);
+            }
+
+            std::sort(values.begin(), values.end());
+
+            overhead[i] = values[values.size() / 2];
+        }
+    }
+
+    counters_result result(std::size_t calls) const {
+        counters_result result;
+
+        for(std::size_t i = 0; i < counter_events; ++i){
+            result.valid[i]  = fds[i] >= 0;
+            result.values[i] = fds[i] >= 0 && calls ? totals[i] / calls : 0.0;
+        }
+
+        return result;
+    }
+
+private:
+    //Counts since start()
+    std::array<double, counter_events> read_sample(){
+        std::array<double, counter_events> values;
+        values.fill(0.0);
+
+#ifdef __linux__
+        ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+        //nr, time_enabled, time_running and then one value per counter
+        std::array<uint64_t, 3 + counter_events> buffer;
+
+        if(::read(leader, buffer.data(), sizeof(buffer)) <= 0){
+            return values;
+        }
+
+        //The reset does not apply to the times, they are totals since the
+        //group has been opened, only the counts are of this sample
+        auto sample_enabled = buffer[1] - enabled;
+        auto sample_running = buffer[2] - running;
+
+        enabled = buffer[1];
+        running = buffer[2];
+
+        //Scale the values if the group has been multiplexed
+        double scale = sample_running == 0 ? 0.0 : static_cast<double>(sample_enabled) / sample_running;
+
+        for(std::size_t i = 0; i < counter_events; ++i){
+            if(fds[i] >= 0){
+                values[i] = buffer[3 + slots[i]] * scale;
+            }
+        }
+#endif
+
+        return values;
+    }
+
+    bool tried = false;
+    bool calibrated = false;
+    int leader = -1;
+    std::size_t active = 0;
+    std::array<int, counter_events> fds;
+    std::array<std::size_t, counter_events> slots{};
+    std::array<double, counter_events> totals;
+    std::array<double, counter_events> overhead{};
+    uint64_t enabled = 0; //time_enabled of the group at the end of the last sample
+    uint64_t running = 0; //time_running of the group at the end of the last sample
+};
+
+} //end of namespace cpm
+
+#endif //CPM_COUNTERS_HPP
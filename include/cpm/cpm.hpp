@@ -14,15 +14,30 @@
 #include <utility>
 #include <functional>
 #include <iomanip>
+#include <limits>
+#include <thread>
+#include <barrier>
+#include <cstring>
 
 #include <sys/utsname.h>
+#include <sys/wait.h>
+#include <signal.h>
 
 #include "compiler.hpp"
 #include "duration.hpp"
+#include "clock.hpp"
+#include "placement.hpp"
+#include "monitor.hpp"
+#include "isolation.hpp"
+#include "histogram.hpp"
+#include "samples.hpp"
+#include "cache.hpp"
+#include "peaks.hpp"
 #include "random.hpp"
 #include "policy.hpp"
 #include "io.hpp"
 #include "json.hpp"
+#include "columns.hpp"
 #include "config.hpp"
 
 namespace cpm {
@@ -145,6 +160,50 @@ void call_functor(Functor& functor, std::tuple<TT...> d){
 }
 #endif
 
+//A batched functor takes the number of calls as first parameter and runs the loop itself
+
+template<typename Functor>
+struct batch_functor {
+    Functor functor;
+};
+
+template<typename Functor>
+batch_functor<std::decay_t<Functor>> batched(Functor&& functor){
+    return {std::forward<Functor>(functor)};
+}
+
+template<typename T>
+struct is_batch_functor : std::false_type {};
+
+template<typename Functor>
+struct is_batch_functor<batch_functor<Functor>> : std::true_type {};
+
+template<typename Functor, typename... Args, std::enable_if_t<!is_batch_functor<std::decay_t<Functor>>::value, int> = 42>
+void call_batch(Functor& functor, std::size_t batch, Args... args){
+    for(std::size_t i = 0; i < batch; ++i){
+        call_functor(functor, args...);
+    }
+}
+
+template<typename Functor, typename... Args, std::enable_if_t<is_batch_functor<std::decay_t<Functor>>::value, int> = 42>
+void call_batch(Functor& functor, std::size_t batch, Args... args){
+    auto with_batch = [&functor, batch](auto&&... a){ functor.functor(batch, std::forward<decltype(a)>(a)...); };
+    call_functor(with_batch, args...);
+}
+
+template<bool Sizes, typename Tuple, typename Functor, typename Sequence, typename... Args, std::enable_if_t<!is_batch_functor<std::decay_t<Functor>>::value, int> = 42>
+void call_batch_with_data(Tuple& data, Functor& functor, Sequence sequence, std::size_t batch, Args... args){
+    for(std::size_t i = 0; i < batch; ++i){
+        call_with_data<Sizes>(data, functor, sequence, args...);
+    }
+}
+
+template<bool Sizes, typename Tuple, typename Functor, typename Sequence, typename... Args, std::enable_if_t<is_batch_functor<std::decay_t<Functor>>::value, int> = 42>
+void call_batch_with_data(Tuple& data, Functor& functor, Sequence sequence, std::size_t batch, Args... args){
+    auto with_batch = [&functor, batch](auto&&... a){ functor.functor(batch, std::forward<decltype(a)>(a)...); };
+    call_with_data<Sizes>(data, with_batch, sequence, args...);
+}
+
 template<typename Functor>
 auto call_flops(Functor& functor){
     return functor();
@@ -217,9 +276,83 @@ inline std::size_t mul_all(std::tuple<TT...> tuple) {
     return mul_all(tuple, std::make_index_sequence<sizeof...(TT)>());
 }
 
-template<typename DefaultPolicy = std_stop_policy>
+//A flops functor with the functor of the bytes moved by a call, which
+//takes the same parameters. It can be given everywhere a flops functor is
+
+template<typename Flops, typename Bytes>
+struct bytes_functor {
+    Flops flops;
+    Bytes bytes;
+};
+
+template<typename Flops, typename Bytes>
+bytes_functor<std::decay_t<Flops>, std::decay_t<Bytes>> with_bytes(Flops&& flops, Bytes&& bytes){
+    return {std::forward<Flops>(flops), std::forward<Bytes>(bytes)};
+}
+
+//The flops default to the product of the sizes
+template<typename Bytes>
+auto with_bytes(Bytes&& bytes){
+    return with_bytes([](auto... args){ return mul_all(args...); }, std::forward<Bytes>(bytes));
+}
+
+//The flops functor of a bytes functor, any other functor is a flops functor
+
+template<typename Functor>
+Functor& flops_of(Functor& functor){
+    return functor;
+}
+
+template<typename Flops, typename Bytes>
+Flops& flops_of(bytes_functor<Flops, Bytes>& functor){
+    return functor.flops;
+}
+
+template<typename Flops, typename Bytes>
+const Flops& flops_of(const bytes_functor<Flops, Bytes>& functor){
+    return functor.flops;
+}
+
+template<typename Functor, typename... Args>
+std::size_t call_bytes(Functor& /*functor*/, Args... /*args*/){
+    return 0;
+}
+
+template<typename Flops, typename Bytes, typename... Args>
+std::size_t call_bytes(bytes_functor<Flops, Bytes>& functor, Args... args){
+    return call_flops(functor.bytes, args...);
+}
+
+template<typename Flops, typename Bytes, typename... Args>
+std::size_t call_bytes(const bytes_functor<Flops, Bytes>& functor, Args... args){
+    return call_flops(functor.bytes, args...);
+}
+
+template<typename DefaultPolicy = std_stop_policy, typename Clock = CPM_CLOCK>
 struct benchmark;
 
+//Complexity of the mean time of a sweep, the size of the parallel measures
+//is their number of threads, they are not fitted
+inline complexity_fit fit_measures(const std::vector<std::size_t>& sizes, const std::vector<measure_result>& results){
+    std::vector<double> n;
+    std::vector<double> times;
+
+    for(std::size_t i = 0; i < std::min(sizes.size(), results.size()); ++i){
+        if(results[i].parallel.threads){
+            return {};
+        }
+
+        n.push_back(sizes[i]);
+        times.push_back(results[i].mean);
+    }
+
+    return fit_complexity(n, times);
+}
+
+inline std::string complexity_str(const complexity_fit& fit){
+    return std::string(fit.name) + " (coefficient: " + duration_str(fit.coefficient, 3) + ", rms: " + to_string_precision(100.0 * fit.rms, 3) + "%)";
+}
+
 struct section_data {
     std::string name;
 
@@ -248,8 +381,10 @@ private:
 public:
     std::size_t warmup = 10;
     std::size_t steps = 50;
+    bool allocation_free = false;
+    bool cold_cache = false;
 
-    section(std::string name, Bench& bench, Flops flops, bool enabled) : bench(bench), flops(flops), enabled(enabled), warmup(bench.warmup), steps(bench.steps) {
+    section(std::string name, Bench& bench, Flops flops, bool enabled) : bench(bench), flops(flops), enabled(enabled), warmup(bench.warmup), steps(bench.steps), allocation_free(bench.allocation_free), cold_cache(bench.cold_cache) {
         data.name = std::move(name);
 
         if(enabled && bench.standard_report){
@@ -312,7 +447,26 @@ public:
         }
     }
 
+    //Measure a functor concurrently, the policy gives the number of threads
+
+    template<typename Functor>
+    void measure_parallel(const std::string& title, Functor functor){
+        if(enabled){
+            bench.template policy_run<Policy>(
+                [&title, &functor, this](auto threads){
+                    auto duration = bench.measure_only_parallel(*this, functor, flops, threads);
+                    this->report(title, threads, duration);
+                    return duration;
+                }
+            );
+        }
+    }
+
     ~section(){
+        if(cold_cache){
+            data.name += " (cold)";
+        }
+
         if(bench.standard_report){
             if(data.names.empty()){
                 return;
@@ -333,13 +487,21 @@ public:
 
             widths[0] = std::max(widths[0], static_cast<int>(title.size()));
 
+            std::vector<complexity_fit> fits;
+            bool fitted = false;
+
+            for(auto& results : data.results){
+                fits.push_back(fit_measures(data.sizes_eff, results));
+                fitted = fitted || fits.back().name;
+            }
+
             for(std::size_t i = 0; i < data.results.size(); ++i){
-                for(auto d : data.results[i]){
-                    if(bench.section_mflops){
-                        widths[i+1] = std::max(widths[i+1], static_cast<int>(mthroughput_str(d.throughput_f).size()));
-                    } else {
-                        widths[i+1] = std::max(widths[i+1], static_cast<int>(duration_str(d.mean).size()));
-                    }
+                for(auto& d : data.results[i]){
+                    widths[i+1] = std::max(widths[i+1], static_cast<int>(summary_str(d).size()));
+                }
+
+                if(fits[i].name){
+                    widths[i+1] = std::max(widths[i+1], static_cast<int>(std::strlen(fits[i].name)));
                 }
             }
 
@@ -382,11 +544,7 @@ public:
                             std::cout << "\033[0;31m";
                         }
 
-                        if(bench.section_mflops){
-                            printf("%*s", widths[r+1], mthroughput_str(data.results[r][i].throughput_f).c_str());
-                        } else {
-                            printf("%*s", widths[r+1], duration_str(data.results[r][i].mean).c_str());
-                        }
+                        printf("%*s", widths[r+1], summary_str(data.results[r][i]).c_str());
                     } else {
                         std::cout << "\033[0;31m";
                         printf("%*s", widths[r+1], "*");
@@ -399,13 +557,30 @@ public:
                 printf("\n");
             }
 
+            //Best fit of each implementation over the sizes
+            if(fitted){
+                std::cout << " " << std::string(tot_width, '-') << std::endl;;
+
+                printf(" | %*s | ", widths[0], "fit");
+                for(std::size_t i = 0; i < fits.size(); ++i){
+                    printf("%*s | ", widths[i+1], fits[i].name ? fits[i].name : "-");
+                }
+                printf("\n");
+            }
+
             std::cout << " " << std::string(tot_width, '-') << std::endl;;
         }
 
-        bench.section_results.push_back(std::move(data));
+        bench.add_section(std::move(data));
     }
 
 private:
+    //Unreliable results (too close to the clock resolution) are marked with a !
+    std::string summary_str(const measure_result& d) const {
+        auto value = bench.section_mflops ? mthroughput_str(d.throughput_f) : duration_str(d.mean);
+        return d.unreliable ? value + "!" : value;
+    }
+
     template<typename Tuple>
     void report(const std::string& title, Tuple d, measure_result& duration){
         if(data.names.empty() || data.names.back() != title){
@@ -420,6 +595,8 @@ private:
 
         duration.update(size_to_eff(d));
 
+        bench.check_allocations(allocation_free, true, data.name + "/" + title + "(" + size_to_string(d) + ")", duration);
+
         data.results.back().push_back(duration);
     }
 };
@@ -429,7 +606,7 @@ struct measure_data {
     std::vector<measure_full> results;
 };
 
-template<typename DefaultPolicy>
+template<typename DefaultPolicy, typename Clock>
 struct benchmark {
 private:
     template<typename Bench, typename Policy, typename Flops> friend struct section;
@@ -454,6 +631,27 @@ private:
     std::string filter_title;
     std::vector<std::string> filter_tags;
 
+    perf_counters counter_group;
+    cpu_placement placement;
+    system_monitor monitor;
+    double measure_start = 0.0;
+
+    int parent_fd = -1; //Pipe to the parent process when running an isolated bench
+    std::vector<failure_data> failures;
+    std::size_t benchs_run = 0; //Position of the next bench in the registration order
+    std::vector<int> slot_cpus; //Cpus of the concurrent benchs
+
+    double timer_overhead = 0.0;   //ns spent in the sampling code for an empty functor
+    double timer_resolution = 0.0; //smallest measurable difference, in ns
+    std::size_t current_batch = 1; //number of calls per sample of the current measure
+    std::vector<double> sample_times; //end of each sample of the current measure, only with raw_samples
+    allocation_counts sample_allocations{0, 0, 0}; //heap operations in the timed regions of the current measure
+    bool allocations_counted = false;
+    resource_result sample_resources{}; //resources used by the sampling of the current measure
+    cache_evictor evictor;
+    bool cold_samples = false; //the caches are evicted before each sample of the current measure
+    machine_peaks machine;
+
 public:
     std::size_t warmup = 10;
     std::size_t steps = 50;
@@ -463,6 +661,41 @@ public:
     bool auto_mkdir = true;
 
     bool section_mflops = false;
+    bool hardware_counters = false;
+    bool subtract_overhead = false;
+    bool batching = false;
+
+    int pin_cpu = -1;          //Core of the measuring thread, -1 to let the scheduler decide
+    bool idle_sibling = false; //Keep the SMT siblings of pin_cpu free
+    bool realtime = false;     //Use SCHED_FIFO if permitted
+    int nice = 0;
+    bool lock_memory = false;  //mlockall if permitted
+
+    bool monitor_system = false; //Sample the state of the machine in the background
+
+    bool isolate = false; //Run each registered bench in a forked process
+    double timeout = 0.0; //Maximum duration of an isolated bench in seconds, 0 for no limit
+    std::size_t slots = 1; //Number of isolated benchs running concurrently, each on its own core
+
+    double precision = 0.0;                            //Target half-width of the confidence interval of the mean relative to the mean, 0 for a fixed number of steps
+    std::size_t min_steps = cpm::precision_min_steps;  //Bounds of the number of samples with a target precision
+    std::size_t max_steps = cpm::precision_max_steps;
+    double max_time = cpm::precision_max_time;         //Maximum seconds of sampling of a measure with a target precision
+
+    std::size_t histogram_digits = cpm::histogram_digits; //Significant digits of the histogram of each measure, 0 to disable
+    bool raw_samples = false; //Save every sample in a binary file next to the results
+
+    bool allocation_free = false; //Fail the measures whose functor allocates, needs CPM_TRACK_ALLOCATIONS
+    bool cold_cache = false;      //Evict the caches before each sample, not for the parallel measures
+
+    bool peaks = false;       //Calibrate the peak bandwidth and flops of the machine and save them with the results
+    bool recalibrate = false; //Measure the peaks even if they are in the cache file
+    std::string peaks_file = default_peaks_file();
+
+    bool binary = false; //Save the results in the binary columnar format (N.cpmb) instead of JSON
+
+    std::size_t resamples = cpm::bootstrap_resamples; //Bootstrap resamples of the confidence intervals, 0 for the normal approximation
+    std::size_t seed = cpm::bootstrap_seed;
 
     benchmark(std::string name, std::string f = ".", std::string t = "", std::string c = "") : name(std::move(name)), folder(std::move(f)), tag(std::move(t)), configuration(std::move(c)) {
         //Get absolute cwd
@@ -519,6 +752,10 @@ public:
 
         //Store the time
         start_time = wall_clock::now();
+
+        //Calibrate the clock used for the measures
+        Clock::calibrate();
+        calibrate_timer();
     }
 
     void set_filter(std::string filter){
@@ -568,23 +805,95 @@ public:
     }
 
     void begin(){
+        std::vector<std::string> slot_warnings;
+
+        //The cpus of the slots are chosen before the main process is pinned
+        if(slots > 1){
+            slot_cpus = spread_cpus(slots);
+
+            if(slot_cpus.size() < slots){
+                slot_warnings.push_back("Only " + std::to_string(slot_cpus.size()) + " cores are available for " + std::to_string(slots) + " slots");
+                slots = std::max(std::size_t(1), slot_cpus.size());
+            }
+
+            isolate = true;
+        }
+
+        //The all-core peaks need all the cpus, before the process is pinned
+        if(peaks){
+            if(standard_report){
+                std::cout << "Calibrate the peaks of the machine..." << std::endl;
+            }
+
+            machine = calibrate_peaks(pin_cpu, peaks_file, recalibrate);
+        }
+
+        place(pin_cpu);
+
+        placement.warnings.insert(placement.warnings.end(), slot_warnings.begin(), slot_warnings.end());
+
+        if(monitor_system){
+            monitor.start(placement.pinned ? placement.cpu : -1, [this](){ placement.move_away(); });
+        }
+
         if(standard_report){
             std::cout << "Start CPM benchmarks" << std::endl;
             if(!folder_ok){
                 std::cout << "   Impossible to save the results (invalid folder)" << std::endl;
             } else if(auto_save){
-                std::cout << "   Results will be automatically saved in " << final_file << std::endl;
+                std::cout << "   Results will be automatically saved in " << results_file() << std::endl;
             } else {
-                std::cout << "   Results will be saved on-demand in " << final_file << std::endl;
+                std::cout << "   Results will be saved on-demand in " << results_file() << std::endl;
             }
 
 #ifdef CPM_AUTO_STEPS
             std::cout << "   Number of steps will be automatically computed" << std::endl;
 #else
             std::cout << "   Each test is warmed-up " << warmup << " times" << std::endl;
-            std::cout << "   Each test is repeated " << steps << " times" << std::endl;
+
+            if(precision <= 0.0){
+                std::cout << "   Each test is repeated " << steps << " times" << std::endl;
+            }
 #endif
 
+            if(precision > 0.0){
+                std::cout << "   Each test is sampled until +/-" << to_string_precision(precision * 100.0, 3) << "% ("
+                    << min_steps << " to " << max_steps << " samples, at most " << to_string_precision(max_time, 3) << "s)" << std::endl;
+            }
+
+            if(raw_samples && folder_ok){
+                std::cout << "   Raw samples will be saved in " << samples_file() << std::endl;
+            }
+
+            if(batching){
+                std::cout << "   Each sample is batched to last at least " << duration_str(cpm::batch_target * 1e9, 3) << std::endl;
+            }
+
+            if(cold_cache){
+                evictor.prepare(placement.pinned ? placement.cpu : 0);
+                std::cout << "   The caches are evicted before each sample (" << throughput_str(evictor.size(), 3) << "B swept)" << std::endl;
+            }
+
+            if(machine.valid){
+                std::cout << "   Peaks" << (machine.cached ? " (cached): " : ": ")
+                    << "triad " << throughput_str(machine.single.triad, 3) << "B/s, "
+                    << throughput_str(machine.single.flops_scalar, 3) << "Flop/s scalar, "
+                    << throughput_str(machine.single.flops_simd, 3) << "Flop/s SIMD";
+
+                if(machine.threads > 1){
+                    std::cout << " (" << machine.threads << " cores: triad " << throughput_str(machine.all.triad, 3) << "B/s, "
+                        << throughput_str(machine.all.flops_simd, 3) << "Flop/s SIMD)";
+                }
+
+                std::cout << std::endl;
+            }
+
+            if(allocation_tracker){
+                std::cout << "   Heap allocations are counted" << (allocation_free ? ", they fail the measures" : "") << std::endl;
+            } else if(allocation_free){
+                std::cout << "   Warning: Heap allocations are not tracked, define CPM_TRACK_ALLOCATIONS" << std::endl;
+            }
+
             auto time = wall_clock::to_time_t(start_time);
             std::cout << "   Time " << std::ctime(&time) << std::endl;
 
@@ -593,6 +902,57 @@ public:
             std::cout << "   Compiler: " << COMPILER_FULL << std::endl;
             std::cout << "   Operating System: " << operating_system << std::endl;
 
+            if(Clock::frequency() > 0.0){
+                std::cout << "   Clock: " << Clock::name() << " (" << to_string_precision(Clock::frequency(), 4) << "GHz)" << std::endl;
+            } else {
+                std::cout << "   Clock: " << Clock::name() << std::endl;
+            }
+
+            if(!Clock::stable()){
+                std::cout << "   Warning: The clock rate is not constant, the measures may be wrong" << std::endl;
+            }
+
+            std::cout << "   Timer overhead: " << duration_str(timer_overhead, 3)
+                << (subtract_overhead ? " (subtracted)" : "")
+                << " resolution: " << duration_str(timer_resolution, 3) << std::endl;
+
+            if(resamples){
+                std::cout << "   Confidence intervals: bootstrap (" << resamples << " resamples, seed " << seed << ")" << std::endl;
+            } else {
+                std::cout << "   Confidence intervals: normal approximation" << std::endl;
+            }
+
+            std::cout << "   Placement: " << placement.str() << std::endl;
+
+            for(auto& warning : placement.warnings){
+                std::cout << "   Warning: " << warning << std::endl;
+            }
+
+            if(slots > 1){
+                std::cout << "   " << slots << " benchs run concurrently on cpus " << slot_cpus_str() << std::endl;
+            }
+
+            if(isolate){
+                std::cout << "   Each bench runs in its own process";
+                if(timeout > 0.0){
+                    std::cout << " (timeout: " << to_string_precision(timeout, 3) << "s)";
+                }
+                std::cout << std::endl;
+            }
+
+            if(monitor_system){
+                std::cout << "   System monitored every " << duration_str(cpm::monitor_interval * 1e9, 3)
+                    << (monitor.governor.empty() ? std::string() : " (governor: " + monitor.governor + ")") << std::endl;
+            }
+
+            if(hardware_counters){
+                if(counter_group.open()){
+                    std::cout << "   Hardware counters: enabled" << std::endl;
+                } else {
+                    std::cout << "   Hardware counters: not available, only time is measured" << std::endl;
+                }
+            }
+
             if(!filter_title.empty()){
                 std::cout << "   Filter by title: " << filter_title << std::endl;
             }
@@ -613,13 +973,24 @@ public:
         end(auto_save);
     }
 
+    //At least one bench crashed, timed out or failed an assertion
+    bool failed() const {
+        return !failures.empty();
+    }
+
     void end(bool save_file = true){
+        monitor.stop();
+
         if(standard_report){
             std::cout << std::endl;
             std::cout << "End of CPM benchmarks" << std::endl;
             std::cout << "   "  << tests << " tests have been run" << std::endl;
             std::cout << "   "  << measures << " measures have been taken" << std::endl;
             std::cout << "   "  << runs << " functors calls" << std::endl;
+
+            if(!failures.empty()){
+                std::cout << "   "  << failures.size() << " benchs failed" << std::endl;
+            }
             std::cout << std::endl;
         }
 
@@ -634,7 +1005,7 @@ public:
     }
 
     template<typename Policy = DefaultPolicy, typename Flops>
-    section<benchmark<DefaultPolicy>, Policy, Flops> multi(const std::string& o_name, Flops&& flops){
+    section<benchmark<DefaultPolicy, Clock>, Policy, Flops> multi(const std::string& o_name, Flops&& flops){
         auto name = o_name;
         bool rename = false;
         std::size_t id = 0;
@@ -659,15 +1030,33 @@ public:
             std::cout << "Warning: Section already exists. Renamed in \"" << name << "\"\n";
         }
 
-        return {std::move(name), *this, std::forward<Flops>(flops), bench_should_run(o_name)};
+        bool enabled = bench_should_run(o_name);
+
+        if(enabled){
+            notify_start(message_type::SECTION_STARTED, name);
+        }
+
+        return {std::move(name), *this, std::forward<Flops>(flops), enabled};
+    }
+
+    template<typename Policy = DefaultPolicy, typename Flops, typename Bytes>
+    auto multi(const std::string& o_name, Flops&& flops, Bytes&& bytes){
+        return multi<Policy>(o_name, with_bytes(std::forward<Flops>(flops), std::forward<Bytes>(bytes)));
     }
 
-    std::string check_title(const std::string& o_name){
+    //The cold measures are tracked apart from the hot ones of the same functor
+    std::string check_title(const std::string& o_name, bool cold = false){
         auto name = o_name;
         trim(name);
         auto tags = extract_tags(name, false);
         name = tags.empty() ? name : extract_title(name);
 
+        //A renamed bench keeps its title without tags and its mode
+        auto title = name;
+        std::string suffix = cold ? " (cold)" : "";
+
+        name = title + suffix;
+
         bool rename = false;
         std::size_t id = 0;
         while(true){
@@ -675,7 +1064,7 @@ public:
 
             for(auto& data : results){
                 if(data.title == name){
-                    name = o_name + "_" + std::to_string(id++);
+                    name = title + "_" + std::to_string(id++) + suffix;
                     rename = true;
                     found = true;
                     break;
@@ -691,9 +1080,120 @@ public:
             std::cout << "Warning: Bench already exists. Renamed in \"" << name << "\"\n";
         }
 
+        notify_start(message_type::BENCH_STARTED, name);
+
         return name;
     }
 
+    //Run a registered bench, in a forked process in isolation mode. The
+    //results are streamed back to this process, so the results of a bench
+    //that crashes or times out are kept until the failure
+
+    template<typename Bench>
+    void run(Bench bench){
+        run(bench, benchs_run);
+    }
+
+    //The index of the bench in the registration order names its failure if
+    //it fails before it starts a measure
+
+    template<typename Bench>
+    void run(Bench bench, std::size_t index){
+        benchs_run = index + 1;
+
+        if(!isolate){
+            bench(*this);
+            return;
+        }
+
+        //Nothing must be printed twice
+        std::cout << std::flush;
+        fflush(stdout);
+
+        child_process child;
+
+        if(!spawn(bench, child, -1, false)){
+            std::cout << "Warning: Impossible to isolate the bench, it runs in the main process" << std::endl;
+            bench(*this);
+            return;
+        }
+
+        child.completed = read_until_closed(child.fd, child.stream, timeout);
+        ::close(child.fd);
+        child.fd = -1;
+
+        if(!child.completed){
+            kill(child.pid, SIGKILL);
+        }
+
+        while(waitpid(child.pid, &child.status, 0) < 0 && errno == EINTR){}
+        child.pid = -1;
+
+        merge(child, index);
+    }
+
+    //Run the registered benchs, up to slots of them concurrently, each in its
+    //own process pinned on its own core. An exclusive bench waits for the
+    //others to finish and runs alone. The results, and the output, are merged
+    //in the order of the registration
+
+    template<typename Bench>
+    void run_all(const std::vector<Bench>& benchs, const std::vector<bool>& exclusive){
+        if(slots <= 1){
+            for(std::size_t i = 0; i < benchs.size(); ++i){
+                run(benchs[i], i);
+            }
+
+            return;
+        }
+
+        std::vector<child_process> children(benchs.size());
+        std::vector<int> free_cpus(slot_cpus.rbegin(), slot_cpus.rend());
+
+        std::size_t next = 0;    //next bench to start
+        std::size_t merged = 0;  //benchs already merged in the results
+        std::size_t running = 0;
+
+        while(merged < benchs.size()){
+            while(merged < next && children[merged].finished()){
+                merge(children[merged], merged);
+                ++merged;
+            }
+
+            if(next < benchs.size()){
+                bool alone = next < exclusive.size() && exclusive[next];
+
+                if(!alone && !free_cpus.empty()){
+                    std::cout << std::flush;
+                    fflush(stdout);
+
+                    if(spawn(benchs[next], children[next], free_cpus.back(), true)){
+                        free_cpus.pop_back();
+                        ++running;
+                        ++next;
+                        continue;
+                    }
+
+                    //Retried alone, with the fallbacks of run()
+                    alone = true;
+                }
+
+                if(alone && !running && merged == next){
+                    run(benchs[next], next);
+                    ++next;
+                    ++merged;
+                    continue;
+                }
+            }
+
+            if(running){
+                wait_children(children, running, free_cpus);
+            }
+        }
+
+        benchs_run = benchs.size();
+    }
+
     //Measure once functor (no policy, no randomization)
 
     template<typename Functor>
@@ -704,7 +1204,7 @@ public:
     template<typename Functor, typename Flops>
     void measure_once(const std::string& o_title, Functor&& functor, Flops&& flops){
         if(bench_should_run(o_title)){
-            auto title = check_title(o_title);
+            auto title = check_title(o_title, cold_cache);
 
             measure_data data;
             data.title = title;
@@ -713,7 +1213,7 @@ public:
             report(title, std::size_t(1), duration);
             data.results.push_back({1, std::string("1"), duration});
 
-            results.push_back(std::move(data));
+            add_result(std::move(data));
         }
     }
 
@@ -724,10 +1224,15 @@ public:
         measure_simple<Policy>(o_title, std::forward<Functor>(functor), [](auto... args){ return mul_all(args...); });
     }
 
+    template<typename Policy = DefaultPolicy, typename Functor, typename Flops, typename Bytes>
+    void measure_simple(const std::string& o_title, Functor&& functor, Flops&& flops, Bytes&& bytes){
+        measure_simple<Policy>(o_title, std::forward<Functor>(functor), with_bytes(std::forward<Flops>(flops), std::forward<Bytes>(bytes)));
+    }
+
     template<typename Policy = DefaultPolicy, typename Functor, typename Flops>
     void measure_simple(const std::string& o_title, Functor&& functor, Flops&& flops){
         if(bench_should_run(o_title)){
-            auto title = check_title(o_title);
+            auto title = check_title(o_title, cold_cache);
 
             if(standard_report){
                 std::cout << std::endl;
@@ -747,7 +1252,7 @@ public:
                 }
             );
 
-            results.push_back(std::move(data));
+            add_result(std::move(data));
         }
     }
 
@@ -758,10 +1263,15 @@ public:
         return measure_two_pass<Sizes, Policy>(o_title, std::forward<Init>(init), std::forward<Functor>(functor), [](auto... args){return mul_all(args...);});
     }
 
+    template<bool Sizes = true, typename Policy= DefaultPolicy, typename Init, typename Functor, typename Flops, typename Bytes>
+    void measure_two_pass(const std::string& o_title, Init&& init, Functor&& functor, Flops&& flops, Bytes&& bytes){
+        return measure_two_pass<Sizes, Policy>(o_title, std::forward<Init>(init), std::forward<Functor>(functor), with_bytes(std::forward<Flops>(flops), std::forward<Bytes>(bytes)));
+    }
+
     template<bool Sizes = true, typename Policy= DefaultPolicy, typename Init, typename Functor, typename Flops>
     void measure_two_pass(const std::string& o_title, Init&& init, Functor&& functor, Flops&& flops){
         if(bench_should_run(o_title)){
-            auto title = check_title(o_title);
+            auto title = check_title(o_title, cold_cache);
 
             if(standard_report){
                 std::cout << std::endl;
@@ -781,7 +1291,7 @@ public:
                 }
             );
 
-            results.push_back(std::move(data));
+            add_result(std::move(data));
         }
     }
 
@@ -795,7 +1305,7 @@ public:
     template<typename Policy = DefaultPolicy, typename Functor, typename Flops, typename... T>
     void measure_global_flops(const std::string& o_title, Functor&& functor, Flops&& flops, T&... references){
         if(bench_should_run(o_title)){
-            auto title = check_title(o_title);
+            auto title = check_title(o_title, cold_cache);
 
             if(standard_report){
                 std::cout << std::endl;
@@ -815,43 +1325,260 @@ public:
                 }
             );
 
-            results.push_back(std::move(data));
+            add_result(std::move(data));
+        }
+    }
+
+    //Measure a functor concurrently on several threads (functor(thread_id, sizes..., threads)
+    //or functor(thread_id) without sizes), the last value of the policy is the number of threads
+
+    template<typename Policy = std_threads_policy, typename Functor>
+    void measure_parallel(const std::string& o_title, Functor&& functor){
+        //By default, the flops are the effective size, as for measure_simple
+        measure_parallel<Policy>(o_title, std::forward<Functor>(functor), [](auto... sizes){
+            if constexpr(sizeof...(sizes) == 1){
+                return parallel_size(sizes...);
+            } else {
+                return parallel_size(std::make_tuple(sizes...));
+            }
+        });
+    }
+
+    template<typename Policy = std_threads_policy, typename Functor, typename Flops>
+    void measure_parallel(const std::string& o_title, Functor&& functor, Flops&& flops){
+        if(bench_should_run(o_title)){
+            auto title = check_title(o_title);
+
+            if(standard_report){
+                std::cout << std::endl;
+            }
+
+            measure_data data;
+            data.title = title;
+
+            policy_run<Policy>(
+                [&data, &title, functor = std::forward<Functor>(functor), flops = std::forward<Flops>(flops), this](auto threads){
+                    using namespace cpm;
+
+                    auto duration = measure_only_parallel(*this, functor, flops, threads);
+                    report(title, threads, duration);
+                    data.results.push_back({parallel_size(threads), size_to_string(threads), duration});
+                    return duration;
+                }
+            );
+
+            add_result(std::move(data));
         }
     }
 
-    //Measure and return the duration of a simple functor
+    //Measure and return the duration of a simple functor, in nanoseconds
 
     template<typename Functor>
     static std::size_t measure_only(Functor functor){
-        auto start_time = timer_clock::now();
+        //Can be called before begin()
+        Clock::calibrate();
+
+        auto start_time = Clock::start();
         functor();
         prologue();
-        auto end_time = timer_clock::now();
-        auto duration = std::chrono::duration_cast<clock_resolution>(end_time - start_time);
+        auto end_time = Clock::stop();
 
-        return duration.count();
+        return Clock::ns(start_time, end_time);
     }
 
 private:
-    void save(){
-        if(!folder_ok){
-            std::cout << "Impossible save, the folder was not correct" << std::endl;
+    template<typename Stream>
+    void write_complexity(Stream& stream, std::size_t& indent, const complexity_fit& fit){
+        if(fit.name){
+            write_value(stream, indent, "complexity", fit.name);
+            write_value(stream, indent, "complexity_coefficient", fit.coefficient);
+            write_value(stream, indent, "complexity_rms", fit.rms);
+        }
+    }
 
-            return;
+    template<typename Stream>
+    void write_result(Stream& stream, std::size_t& indent, const std::string& size, std::size_t size_eff, const measure_result& result){
+        write_value(stream, indent, "size", size);
+        write_value(stream, indent, "size_eff", size_eff);
+        write_value(stream, indent, "mean", result.mean);
+        write_value(stream, indent, "mean_lb", result.mean_lb);
+        write_value(stream, indent, "mean_ub", result.mean_ub);
+        write_value(stream, indent, "stddev", result.stddev);
+        write_value(stream, indent, "min", result.min);
+        write_value(stream, indent, "max", result.max);
+        write_value(stream, indent, "median", result.robust.median);
+        write_value(stream, indent, "median_lb", result.robust.median_lb);
+        write_value(stream, indent, "median_ub", result.robust.median_ub);
+        write_value(stream, indent, "p90", result.robust.p90);
+        write_value(stream, indent, "p99", result.robust.p99);
+        write_value(stream, indent, "p999", result.robust.p999);
+        write_value(stream, indent, "q1", result.robust.q1);
+        write_value(stream, indent, "q3", result.robust.q3);
+        write_value(stream, indent, "mad", result.robust.mad);
+        write_value(stream, indent, "iqr", result.robust.iqr);
+        write_value(stream, indent, "mild_outliers", result.robust.mild_outliers);
+        write_value(stream, indent, "severe_outliers", result.robust.severe_outliers);
+        write_value(stream, indent, "samples", result.samples);
+        write_value(stream, indent, "precision", result.precision);
+        if(!result.histogram.empty()){
+            write_value(stream, indent, "histogram", result.histogram);
         }
 
-        auto time = wall_clock::to_time_t(start_time);
-        std::stringstream ss;
-        ss << std::ctime(&time);
-        auto time_str = ss.str();
+        write_value(stream, indent, "unreliable", result.unreliable);
+        write_value(stream, indent, "batch", result.batch);
+        write_value(stream, indent, "cache", result.cold ? "cold" : "hot");
 
-        if(time_str.back() == '\n'){
-            time_str.pop_back();
+        if(result.allocations.tracked){
+            write_value(stream, indent, "allocations", result.allocations.allocations);
+            write_value(stream, indent, "deallocations", result.allocations.deallocations);
+            write_value(stream, indent, "allocated_bytes", result.allocations.bytes);
         }
 
-        std::ofstream stream(final_file);
+        if(result.resources.measured){
+            write_value(stream, indent, "rss_growth", result.resources.rss_growth);
+            write_value(stream, indent, "minor_faults", result.resources.minor_faults);
+            write_value(stream, indent, "major_faults", result.resources.major_faults);
+            write_value(stream, indent, "voluntary_switches", result.resources.voluntary_switches);
+            write_value(stream, indent, "involuntary_switches", result.resources.involuntary_switches);
+        }
 
-        stream << "{\n";
+        //Only the counters that were available are saved
+        for(std::size_t i = 0; i < counter_events; ++i){
+            if(result.counters.valid[i]){
+                write_value(stream, indent, counter_name(i), result.counters.values[i]);
+            }
+        }
+
+        if(result.counters.has(counter_event::CYCLES) && result.counters.has(counter_event::INSTRUCTIONS)){
+            write_value(stream, indent, "ipc", result.counters.ipc());
+        }
+
+        if(result.parallel.threads){
+            write_value(stream, indent, "threads", result.parallel.threads);
+
+            if(result.parallel.work){
+                write_value(stream, indent, "work", result.parallel.work);
+            }
+
+            write_value(stream, indent, "wall", result.parallel.wall);
+            write_value(stream, indent, "ops", result.parallel.throughput);
+            write_value(stream, indent, "fairness", result.parallel.fairness);
+
+            start_array(stream, indent, "thread_results");
+
+            auto& per_thread = result.parallel.per_thread;
+
+            for(std::size_t t = 0; t < per_thread.size(); ++t){
+                start_sub(stream, indent);
+
+                write_value(stream, indent, "thread", t);
+                write_value(stream, indent, "mean", per_thread[t].mean);
+                write_value(stream, indent, "stddev", per_thread[t].stddev);
+                write_value(stream, indent, "min", per_thread[t].min);
+                write_value(stream, indent, "max", per_thread[t].max);
+                write_value(stream, indent, "ops", per_thread[t].throughput, false);
+
+                close_sub(stream, indent, t < per_thread.size() - 1);
+            }
+
+            close_array(stream, indent, true);
+        }
+
+        write_value(stream, indent, "throughput", result.throughput_e);
+        write_value(stream, indent, "throughput_e", result.throughput_e);
+        write_value(stream, indent, "throughput_f", result.throughput_f, !!result.bytes);
+
+        if(result.bytes){
+            write_value(stream, indent, "bytes", result.bytes);
+            write_value(stream, indent, "throughput_b", result.throughput_b);
+            write_value(stream, indent, "intensity", result.intensity, false);
+        }
+    }
+
+    //Compact state of the machine while the given results were measured
+    template<typename Stream, typename Results>
+    void write_system(Stream& stream, std::size_t& indent, const Results& results){
+        if(!monitor.used() || results.empty()){
+            return;
+        }
+
+        double start = std::numeric_limits<double>::max();
+        double end = 0.0;
+
+        for(auto& result : results){
+            start = std::min(start, result.start);
+            end = std::max(end, result.end);
+        }
+
+        auto system = monitor.summary(start, end);
+
+        std::vector<double> time, mhz, temperature, load, steal, iowait;
+
+        for(auto& sample : system.samples){
+            time.push_back(sample.time);
+            mhz.push_back(sample.mhz);
+            temperature.push_back(sample.temperature);
+            load.push_back(sample.load);
+            steal.push_back(sample.steal);
+            iowait.push_back(sample.iowait);
+        }
+
+        write_array(stream, indent, "system_time", time);
+        write_array(stream, indent, "system_mhz", mhz);
+        write_array(stream, indent, "system_temperature", temperature);
+        write_array(stream, indent, "system_load", load);
+        write_array(stream, indent, "system_steal", steal);
+        write_array(stream, indent, "system_iowait", iowait);
+        write_value(stream, indent, "system_mhz_min", system.mhz_min);
+        write_value(stream, indent, "system_mhz_max", system.mhz_max);
+        write_value(stream, indent, "system_temperature_max", system.temperature_max);
+        write_value(stream, indent, "system_load_max", system.load_max);
+        write_value(stream, indent, "system_throttled", system.throttled);
+        write_value(stream, indent, "system_loaded", system.loaded);
+    }
+
+    void save(){
+        if(!folder_ok){
+            std::cout << "Impossible save, the folder was not correct" << std::endl;
+
+            return;
+        }
+
+        if(binary){
+            column_writer writer;
+
+            write_document(writer);
+
+            if(!writer.write(results_file())){
+                std::cout << "Impossible to save the results in " << results_file() << std::endl;
+            }
+        } else {
+            std::ofstream stream(final_file);
+
+            stream << "{\n";
+
+            write_document(stream);
+
+            stream << "}";
+        }
+    }
+
+    //Same file name, with the extension of the format
+    std::string results_file() const {
+        return binary ? final_file + "b" : final_file;
+    }
+
+    //The JSON and the columnar documents are written by the same calls
+    template<typename Stream>
+    void write_document(Stream& stream){
+        auto time = wall_clock::to_time_t(start_time);
+        std::stringstream ss;
+        ss << std::ctime(&time);
+        auto time_str = ss.str();
+
+        if(time_str.back() == '\n'){
+            time_str.pop_back();
+        }
 
         std::size_t indent = 2;
 
@@ -860,6 +1587,82 @@ private:
         write_value(stream, indent, "configuration", configuration);
         write_value(stream, indent, "compiler", COMPILER_FULL);
         write_value(stream, indent, "os", operating_system);
+        write_value(stream, indent, "clock", Clock::name());
+
+        if(Clock::frequency() > 0.0){
+            write_value(stream, indent, "clock_frequency", Clock::frequency());
+        }
+
+        write_value(stream, indent, "clock_overhead", timer_overhead);
+        write_value(stream, indent, "clock_resolution", timer_resolution);
+        write_value(stream, indent, "overhead_subtracted", subtract_overhead);
+
+        if(precision > 0.0){
+            write_value(stream, indent, "precision_target", precision);
+            write_value(stream, indent, "precision_min_steps", min_steps);
+            write_value(stream, indent, "precision_max_steps", max_steps);
+            write_value(stream, indent, "precision_max_time", max_time);
+        }
+
+        if(histogram_digits){
+            write_value(stream, indent, "histogram_digits", histogram_digits);
+            write_value(stream, indent, "histogram_unit", "ps");
+        }
+
+        if(evictor.size()){
+            write_value(stream, indent, "cold_cache_size", evictor.size());
+        }
+
+        if(machine.valid){
+            write_value(stream, indent, "peak_cpu", machine.cpu);
+            write_value(stream, indent, "peak_threads", machine.threads);
+            write_value(stream, indent, "peak_simd_bytes", cpm::simd_bytes);
+
+            for(auto* p : {&machine.single, &machine.all}){
+                std::string suffix = p == &machine.all ? "_all" : "";
+
+                write_value(stream, indent, "peak_copy" + suffix, p->copy);
+                write_value(stream, indent, "peak_scale" + suffix, p->scale);
+                write_value(stream, indent, "peak_add" + suffix, p->add);
+                write_value(stream, indent, "peak_triad" + suffix, p->triad);
+                write_value(stream, indent, "peak_flops_scalar" + suffix, p->flops_scalar);
+                write_value(stream, indent, "peak_flops_simd" + suffix, p->flops_simd);
+            }
+        }
+
+        if(raw_samples){
+            if(save_samples()){
+                write_value(stream, indent, "samples_file", samples_file().substr(folder.size()));
+            } else {
+                std::cout << "Impossible to save the raw samples in " << samples_file() << std::endl;
+            }
+        }
+
+        write_value(stream, indent, "ci_method", resamples ? "bootstrap" : "normal");
+        write_value(stream, indent, "ci_level", 0.95);
+
+        if(resamples){
+            write_value(stream, indent, "ci_resamples", resamples);
+            write_value(stream, indent, "ci_seed", seed);
+        }
+
+        write_value(stream, indent, "placement", slots > 1 ? placement.str() + ", " + std::to_string(slots) + " slots on cpus " + slot_cpus_str() : placement.str());
+        write_value(stream, indent, "placement_cpu", placement.pinned ? placement.cpu : -1);
+        write_value(stream, indent, "placement_siblings", placement.siblings_str());
+        write_value(stream, indent, "placement_sibling_load", placement.sibling_load);
+        write_value(stream, indent, "placement_scheduler", placement.fifo ? "fifo" : "other");
+        write_value(stream, indent, "placement_nice", placement.applied_nice);
+        write_value(stream, indent, "placement_mlock", placement.locked);
+        write_value(stream, indent, "slots", slots);
+        write_value(stream, indent, "slot_cpus", slot_cpus_str());
+
+        if(monitor.used()){
+            if(!monitor.governor.empty()){
+                write_value(stream, indent, "governor", monitor.governor);
+            }
+
+            write_value(stream, indent, "monitor_interval", cpm::monitor_interval);
+        }
 
         write_value(stream, indent, "time", time_str);
         write_value(stream, indent, "timestamp", std::chrono::duration_cast<seconds>(start_time.time_since_epoch()).count());
@@ -872,6 +1675,17 @@ private:
             start_sub(stream, indent);
 
             write_value(stream, indent, "title", result.title);
+
+            std::vector<std::size_t> sizes;
+            std::vector<measure_result> measured;
+            for(auto& sub : result.results){
+                sizes.push_back(sub.size_eff);
+                measured.push_back(sub.result);
+            }
+
+            write_complexity(stream, indent, fit_measures(sizes, measured));
+            write_system(stream, indent, measured);
+
             start_array(stream, indent, "results");
 
             for(std::size_t j = 0; j < result.results.size(); ++j){
@@ -879,17 +1693,7 @@ private:
 
                 start_sub(stream, indent);
 
-                write_value(stream, indent, "size", sub.size);
-                write_value(stream, indent, "size_eff", sub.size_eff);
-                write_value(stream, indent, "mean", sub.result.mean);
-                write_value(stream, indent, "mean_lb", sub.result.mean_lb);
-                write_value(stream, indent, "mean_ub", sub.result.mean_ub);
-                write_value(stream, indent, "stddev", sub.result.stddev);
-                write_value(stream, indent, "min", sub.result.min);
-                write_value(stream, indent, "max", sub.result.max);
-                write_value(stream, indent, "throughput", sub.result.throughput_e);
-                write_value(stream, indent, "throughput_e", sub.result.throughput_e);
-                write_value(stream, indent, "throughput_f", sub.result.throughput_f, false);
+                write_result(stream, indent, sub.size, sub.size_eff, sub.result);
 
                 close_sub(stream, indent, j < result.results.size() - 1);
             }
@@ -908,6 +1712,14 @@ private:
             start_sub(stream, indent);
 
             write_value(stream, indent, "name", section.name);
+
+            std::vector<measure_result> measured;
+            for(auto& implementation : section.results){
+                measured.insert(measured.end(), implementation.begin(), implementation.end());
+            }
+
+            write_system(stream, indent, measured);
+
             start_array(stream, indent, "results");
 
             for(std::size_t j = 0; j < section.names.size(); ++j){
@@ -916,22 +1728,13 @@ private:
                 start_sub(stream, indent);
 
                 write_value(stream, indent, "name", name);
+                write_complexity(stream, indent, fit_measures(section.sizes_eff, section.results[j]));
                 start_array(stream, indent, "results");
 
                 for(std::size_t k = 0; k < section.results[j].size(); ++k){
                     start_sub(stream, indent);
 
-                    write_value(stream, indent, "size", section.sizes[k]);
-                    write_value(stream, indent, "size_eff", section.sizes_eff[k]);
-                    write_value(stream, indent, "mean", section.results[j][k].mean);
-                    write_value(stream, indent, "mean_lb", section.results[j][k].mean_lb);
-                    write_value(stream, indent, "mean_ub", section.results[j][k].mean_ub);
-                    write_value(stream, indent, "stddev", section.results[j][k].stddev);
-                    write_value(stream, indent, "min", section.results[j][k].min);
-                    write_value(stream, indent, "max", section.results[j][k].max);
-                    write_value(stream, indent, "throughput", section.results[j][k].throughput_e);
-                    write_value(stream, indent, "throughput_e", section.results[j][k].throughput_e);
-                    write_value(stream, indent, "throughput_f", section.results[j][k].throughput_f, false);
+                    write_result(stream, indent, section.sizes[k], section.sizes_eff[k], section.results[j][k]);
 
                     close_sub(stream, indent, k < section.results[j].size() - 1);
                 }
@@ -944,9 +1747,50 @@ private:
             close_sub(stream, indent, i < section_results.size() - 1);
         }
 
-        close_array(stream, indent, false);
+        close_array(stream, indent, !failures.empty());
+
+        if(!failures.empty()){
+            start_array(stream, indent, "failures");
+
+            for(std::size_t i = 0; i < failures.size(); ++i){
+                start_sub(stream, indent);
 
-        stream << "}";
+                write_value(stream, indent, "title", failures[i].title);
+                write_value(stream, indent, "section", failures[i].section);
+                write_value(stream, indent, "reason", failures[i].reason, false);
+
+                close_sub(stream, indent, i < failures.size() - 1);
+            }
+
+            close_array(stream, indent, false);
+        }
+    }
+
+    std::string samples_file() const {
+        return final_file.substr(0, final_file.size() - 4) + ".samples";
+    }
+
+    //Write the samples of every measure, a bench is identified by its title
+    //and a section by its name and the name of the implementation
+    bool save_samples(){
+        std::vector<sample_series> series;
+
+        for(auto& result : results){
+            for(auto& sub : result.results){
+                series.push_back({result.title, "", sub.size, &sub.result.raw_durations, &sub.result.raw_times});
+            }
+        }
+
+        for(auto& section : section_results){
+            for(std::size_t j = 0; j < section.names.size(); ++j){
+                for(std::size_t k = 0; k < section.results[j].size(); ++k){
+                    auto& result = section.results[j][k];
+                    series.push_back({section.name, section.names[j], section.sizes[k], &result.raw_durations, &result.raw_times});
+                }
+            }
+        }
+
+        return write_samples(samples_file(), series);
     }
 
     template<typename Policy, typename M>
@@ -966,7 +1810,441 @@ private:
         }
     }
 
-    measure_result measure(const std::vector<std::size_t>& durations, std::size_t flops = 1){
+    std::string slot_cpus_str() const {
+        std::string result;
+
+        for(auto cpu : slot_cpus){
+            result += (result.empty() ? "" : ",") + std::to_string(cpu);
+        }
+
+        return result;
+    }
+
+    //Apply the placement settings with the given measuring cpu
+    void place(int cpu){
+        placement = cpu_placement();
+        placement.cpu = cpu;
+        placement.idle_siblings = idle_sibling;
+        placement.realtime = realtime;
+        placement.nice = nice;
+        placement.lock_memory = lock_memory;
+
+        if(placement.requested()){
+            placement.apply();
+
+            //The timer must be calibrated where the measures are taken
+            calibrate_timer();
+        }
+    }
+
+    //Fork a process running the bench, pinned on cpu if not negative
+    template<typename Bench>
+    bool spawn(Bench& bench, child_process& child, int cpu, bool capture){
+        int fds[2];
+        if(pipe(fds)){
+            return false;
+        }
+
+        int output[2] = {-1, -1};
+        if(capture && pipe(output)){
+            ::close(fds[0]);
+            ::close(fds[1]);
+            return false;
+        }
+
+        auto pid = fork();
+
+        if(pid < 0){
+            for(auto fd : {fds[0], fds[1], output[0], output[1]}){
+                if(fd >= 0){
+                    ::close(fd);
+                }
+            }
+
+            return false;
+        }
+
+        if(pid == 0){
+            ::close(fds[0]);
+
+            if(capture){
+                ::close(output[0]);
+                dup2(output[1], STDOUT_FILENO);
+                dup2(output[1], STDERR_FILENO);
+                ::close(output[1]);
+            }
+
+            if(cpu >= 0){
+                place(cpu);
+
+                for(auto& warning : placement.warnings){
+                    std::cout << "Warning: " << warning << std::endl;
+                }
+            }
+
+            run_child(bench, fds[1]);
+        }
+
+        ::close(fds[1]);
+
+        if(capture){
+            ::close(output[1]);
+        }
+
+        child.pid = pid;
+        child.fd = fds[0];
+        child.output_fd = output[0];
+        child.cpu = cpu;
+        child.start = timer_clock::now();
+
+        return true;
+    }
+
+    //Wait until at least one of the running children terminates
+    void wait_children(std::vector<child_process>& children, std::size_t& running, std::vector<int>& free_cpus){
+        std::vector<pollfd> fds;
+        std::vector<std::pair<std::size_t, bool>> owners; //child and output or not
+
+        int wait = -1;
+
+        for(std::size_t i = 0; i < children.size(); ++i){
+            auto& child = children[i];
+
+            if(child.pid < 0){
+                continue;
+            }
+
+            if(child.fd >= 0){
+                fds.push_back({child.fd, POLLIN, 0});
+                owners.emplace_back(i, false);
+            }
+
+            if(child.output_fd >= 0){
+                fds.push_back({child.output_fd, POLLIN, 0});
+                owners.emplace_back(i, true);
+            }
+
+            if(timeout > 0.0 && child.completed){
+                auto elapsed = std::chrono::duration_cast<millseconds>(timer_clock::now() - child.start).count() / 1000.0;
+                auto remaining = std::max(0, static_cast<int>((timeout - elapsed) * 1000.0) + 1);
+                wait = wait < 0 ? remaining : std::min(wait, remaining);
+            }
+        }
+
+        if(!fds.empty() && ::poll(fds.data(), fds.size(), wait) > 0){
+            for(std::size_t i = 0; i < fds.size(); ++i){
+                if(fds[i].revents){
+                    auto& child = children[owners[i].first];
+
+                    if(owners[i].second){
+                        read_available(child.output_fd, child.output);
+                    } else {
+                        read_available(child.fd, child.stream);
+                    }
+                }
+            }
+        }
+
+        for(auto& child : children){
+            if(child.pid < 0){
+                continue;
+            }
+
+            if(timeout > 0.0 && child.completed){
+                auto elapsed = std::chrono::duration_cast<millseconds>(timer_clock::now() - child.start).count() / 1000.0;
+
+                if(elapsed >= timeout){
+                    kill(child.pid, SIGKILL);
+                    child.completed = false;
+                }
+            }
+
+            //Once the pipes are closed, the process is gone or about to be
+            if(child.fd < 0 && child.output_fd < 0){
+                while(waitpid(child.pid, &child.status, 0) < 0 && errno == EINTR){}
+
+                child.pid = -1;
+                free_cpus.push_back(child.cpu);
+                --running;
+            }
+        }
+    }
+
+    //Benchs running concurrently cannot see the names of the others, the
+    //duplicates are renamed as they would have been in a single process
+    template<typename Data, typename Name>
+    static std::string merged_name(const std::vector<Data>& data, const std::string& o_name, Name name_of){
+        auto name = o_name;
+        std::size_t id = 0;
+
+        while(std::find_if(data.begin(), data.end(), [&](auto& d){ return name_of(d) == name; }) != data.end()){
+            name = o_name + "_" + std::to_string(id++);
+        }
+
+        if(name != o_name){
+            std::cout << "Warning: \"" << o_name << "\" already exists. Renamed in \"" << name << "\"\n";
+        }
+
+        return name;
+    }
+
+    //Merge the results of the index-th bench, run by a terminated child
+    void merge(child_process& child, std::size_t index){
+        if(!child.output.empty()){
+            std::cout << child.output << std::flush;
+        }
+
+        failure_data failure{"", false, ""};
+        bool pending = false;
+
+        for(auto& m : split_messages(child.stream)){
+            message_reader reader{child.stream, m.begin, m.end};
+
+            switch(m.type){
+                case message_type::BENCH_STARTED:
+                case message_type::SECTION_STARTED:
+                    reader.value(failure.title);
+                    failure.section = m.type == message_type::SECTION_STARTED;
+                    pending = true;
+                    break;
+
+                case message_type::BENCH_RESULT:
+                    {
+                        auto data = read_result(reader);
+                        data.title = merged_name(results, data.title, [](auto& r){ return r.title; });
+                        results.push_back(std::move(data));
+                    }
+                    pending = false;
+                    break;
+
+                case message_type::SECTION_RESULT:
+                    {
+                        auto data = read_section(reader);
+                        data.name = merged_name(section_results, data.name, [](auto& r){ return r.name; });
+                        section_results.push_back(std::move(data));
+                    }
+                    pending = false;
+                    break;
+
+                case message_type::STATISTICS:
+                    {
+                        //The process only sends what it added to the counts
+                        std::size_t child_tests = 0;
+                        std::size_t child_measures = 0;
+                        std::size_t child_runs = 0;
+
+                        reader.value(child_tests);
+                        reader.value(child_measures);
+                        reader.value(child_runs);
+
+                        tests += child_tests;
+                        measures += child_measures;
+                        runs += child_runs;
+                    }
+                    break;
+
+                case message_type::ERROR:
+                    reader.value(failure.reason);
+                    break;
+
+                case message_type::FAILURE:
+                    {
+                        failure_data assertion{"", false, ""};
+                        reader.value(assertion.title);
+                        reader.value(assertion.section);
+                        reader.value(assertion.reason);
+                        failures.push_back(std::move(assertion));
+                    }
+                    break;
+            }
+        }
+
+        auto status = child.status;
+
+        if(!child.completed){
+            failure.reason = "timeout after " + to_string_precision(timeout, 3) + "s";
+        } else if(WIFSIGNALED(status)){
+            failure.reason = std::string("killed by signal ") + strsignal(WTERMSIG(status));
+        } else if(WIFEXITED(status) && WEXITSTATUS(status) && failure.reason.empty()){
+            failure.reason = "exit code " + std::to_string(WEXITSTATUS(status));
+        } else if(WIFEXITED(status) && !WEXITSTATUS(status)){
+            failure.reason.clear();
+        }
+
+        if(!failure.reason.empty()){
+            if(!pending){
+                failure.title = "bench " + std::to_string(index + 1);
+            }
+
+            if(standard_report){
+                std::cout << "Error: " << failure.title << " failed: " << failure.reason << std::endl;
+            }
+
+            failures.push_back(std::move(failure));
+        }
+
+        //The streams can be large
+        child.stream = std::string();
+        child.output = std::string();
+    }
+
+    template<typename Bench>
+    [[noreturn]] void run_child(Bench& bench, int fd){
+        parent_fd = fd;
+
+        //The events of the parent do not count this process
+        counter_group.reset();
+
+        auto base_tests = tests;
+        auto base_measures = measures;
+        auto base_runs = runs;
+        auto base_failures = failures.size();
+
+        int status = 0;
+
+        try {
+            bench(*this);
+        } catch (const std::exception& e){
+            message_writer writer;
+            writer.value(std::string(e.what()));
+            writer.send(parent_fd, message_type::ERROR);
+            status = 1;
+        } catch (...){
+            message_writer writer;
+            writer.value(std::string("unknown exception"));
+            writer.send(parent_fd, message_type::ERROR);
+            status = 1;
+        }
+
+        //The results are kept, the failed assertions are only reported
+        for(std::size_t i = base_failures; i < failures.size(); ++i){
+            message_writer writer;
+            writer.value(failures[i].title);
+            writer.value(failures[i].section);
+            writer.value(failures[i].reason);
+            writer.send(parent_fd, message_type::FAILURE);
+        }
+
+        message_writer writer;
+        writer.value(tests - base_tests);
+        writer.value(measures - base_measures);
+        writer.value(runs - base_runs);
+        writer.send(parent_fd, message_type::STATISTICS);
+
+        std::cout << std::flush;
+
+        //The parent saves the results
+        _exit(status);
+    }
+
+    //A measure that allocates while it should not is kept but reported as a failure
+    void check_allocations(bool expected_free, bool in_section, const std::string& title, const measure_result& result){
+        if(!expected_free || !result.allocations.tracked || (result.allocations.allocations == 0.0 && result.allocations.deallocations == 0.0)){
+            return;
+        }
+
+        failure_data failure{title, in_section,
+            to_string_precision(result.allocations.allocations, 3) + " allocations and "
+            + to_string_precision(result.allocations.deallocations, 3) + " deallocations per call"};
+
+        std::cout << "Error: " << failure.title << " is not allocation free: " << failure.reason << std::endl;
+
+        failures.push_back(std::move(failure));
+    }
+
+    void notify_start(message_type type, const std::string& name){
+        if(parent_fd >= 0){
+            message_writer writer;
+            writer.value(name);
+            writer.send(parent_fd, type);
+        }
+    }
+
+    void add_result(measure_data&& data){
+        if(standard_report){
+            std::vector<std::size_t> sizes;
+            std::vector<measure_result> measured;
+
+            for(auto& sub : data.results){
+                sizes.push_back(sub.size_eff);
+                measured.push_back(sub.result);
+            }
+
+            auto fit = fit_measures(sizes, measured);
+
+            if(fit.name){
+                std::cout << data.title << " complexity: " << complexity_str(fit) << std::endl;
+            }
+        }
+
+        if(parent_fd >= 0){
+            message_writer writer;
+            writer.value(data.title);
+            writer.value(uint64_t(data.results.size()));
+
+            for(auto& sub : data.results){
+                writer.value(sub.size_eff);
+                writer.value(sub.size);
+                writer.value(sub.result);
+            }
+
+            writer.send(parent_fd, message_type::BENCH_RESULT);
+        }
+
+        results.push_back(std::move(data));
+    }
+
+    void add_section(section_data&& data){
+        if(parent_fd >= 0){
+            message_writer writer;
+            writer.value(data.name);
+            writer.value(data.names);
+            writer.value(data.sizes);
+            writer.value(data.sizes_eff);
+            writer.value(data.results);
+            writer.send(parent_fd, message_type::SECTION_RESULT);
+        }
+
+        section_results.push_back(std::move(data));
+    }
+
+    static measure_data read_result(message_reader& reader){
+        measure_data data;
+        reader.value(data.title);
+
+        uint64_t size = 0;
+        reader.value(size);
+
+        for(uint64_t i = 0; i < size && reader.good(); ++i){
+            measure_full sub;
+            reader.value(sub.size_eff);
+            reader.value(sub.size);
+            reader.value(sub.result);
+            data.results.push_back(std::move(sub));
+        }
+
+        return data;
+    }
+
+    static section_data read_section(message_reader& reader){
+        section_data data;
+        reader.value(data.name);
+        reader.value(data.names);
+        reader.value(data.sizes);
+        reader.value(data.sizes_eff);
+        reader.value(data.results);
+        return data;
+    }
+
+    void begin_measure(){
+        ++measures;
+        measure_start = monitor.now();
+        allocations_counted = false;
+        sample_resources = {};
+        cold_samples = false;
+    }
+
+    measure_result measure(const std::vector<double>& durations, std::size_t flops = 1, std::size_t bytes = 0){
         auto n = durations.size();
 
         double mean = 0.0;
@@ -994,12 +2272,293 @@ private:
         double mean_lb = mean - 1.96 * stderror;
         double mean_ub = mean + 1.96 * stderror;
 
-        return {mean, mean_lb, mean_ub, stddev, min, max, 0.0, 0.0, flops};
+        measure_result result{mean, mean_lb, mean_ub, stddev, min, max, 0.0, 0.0, flops, {}};
+
+        result.bytes = bytes;
+        result.start = measure_start;
+        result.end = monitor.now();
+
+        result.robust = robust_stats(durations);
+
+        //The samples are rarely normally distributed
+        if(resamples){
+            auto ci = bootstrap(durations, resamples, seed, [this](){ placement.release_worker(); });
+
+            result.mean_lb = ci.mean_lb;
+            result.mean_ub = ci.mean_ub;
+            result.robust.median_lb = ci.median_lb;
+            result.robust.median_ub = ci.median_ub;
+        }
+
+        if(histogram_digits){
+            result.histogram = encode_histogram(durations, histogram_digits);
+        }
+
+        if(raw_samples){
+            result.raw_durations = durations;
+
+            //The parallel measures do not time their samples one by one
+            if(sample_times.size() == durations.size()){
+                result.raw_times.swap(sample_times);
+            }
+
+            sample_times.clear();
+        }
+
+        result.samples = n;
+        result.precision = mean == 0.0 ? 0.0 : (result.mean_ub - result.mean_lb) / 2.0 / mean;
+
+        //The resolution applies to a complete sample, not to a single call
+        result.unreliable = mean * current_batch < cpm::unreliable_factor * timer_resolution;
+        result.batch = current_batch;
+
+        if(hardware_counters){
+            result.counters = counter_group.result(n * current_batch);
+        }
+
+        //The parallel measures call the functor in other threads
+        result.resources = sample_resources;
+        result.cold = cold_samples;
+
+        if(allocations_counted){
+            const double calls = n * current_batch;
+
+            result.allocations.tracked = true;
+            result.allocations.allocations = sample_allocations.allocations / calls;
+            result.allocations.deallocations = sample_allocations.deallocations / calls;
+            result.allocations.bytes = sample_allocations.bytes / calls;
+        }
+
+        return result;
+    }
+
+    //Select the number of calls per sample so that a sample lasts at least batch_target
+
+    template<typename Prepare, typename Call>
+    std::size_t select_batch(Prepare& prepare, Call& call){
+        //Only the first call of a batch would be cold
+        if(!batching || cold_samples){
+            return 1;
+        }
+
+        const double target = cpm::batch_target * 1000.0 * 1000.0 * 1000.0;
+
+        std::size_t batch = 1;
+
+        while(batch < (1UL << 30)){
+            prepare();
+
+            auto start_time = Clock::start();
+            call(batch);
+            auto end_time = Clock::stop();
+
+            runs += batch;
+
+            auto elapsed = Clock::ns(start_time, end_time);
+
+            if(elapsed >= target){
+                break;
+            }
+
+            batch *= 2;
+        }
+
+        return batch;
+    }
+
+    //Take the timed samples, prepare is called before each sample, outside of the timed region
+    //The durations are returned per call, each sample timing a batch of calls
+
+    template<typename Prepare, typename Call>
+    std::vector<double> measure_samples(std::size_t steps, Prepare prepare, Call call){
+        if(cold_samples){
+            evictor.prepare(placement.pinned ? placement.cpu : 0);
+        }
+
+        current_batch = select_batch(prepare, call);
+
+        const std::size_t batch = current_batch;
+
+        bool counting = hardware_counters && counter_group.open();
+
+        if(counting){
+            counter_group.calibrate([](){
+                Clock::start();
+                Clock::stop();
+            });
+
+            counter_group.clear();
+        }
+
+        std::vector<double> durations;
+
+        sample_times.clear();
+
+        sample_allocations = {0, 0, 0};
+        allocations_counted = allocation_tracker;
+
+        //The functor only runs in this thread
+        auto resources = read_resource_usage(true);
+
+        if(precision > 0.0){
+            //Sample by rounds until the confidence interval is narrow enough
+            auto start_time = timer_clock::now();
+
+            auto expired = [this, start_time](){
+                return std::chrono::duration<double>(timer_clock::now() - start_time).count() >= max_time;
+            };
+
+            std::size_t round = std::max(std::size_t(2), min_steps);
+
+            while(true){
+                take_samples(durations, round, batch, counting, prepare, call, expired);
+
+                if(durations.size() >= max_steps || expired() || sample_precision(durations) <= precision){
+                    break;
+                }
+
+                //Grow geometrically so that the checks stay cheap
+                round = std::min(max_steps - durations.size(), std::max(std::size_t(1), durations.size() / 2));
+            }
+        } else {
+            auto never = [](){ return false; };
+
+            take_samples(durations, steps, batch, counting, prepare, call, never);
+        }
+
+        sample_resources = resource_difference(resources, read_resource_usage(true));
+
+        return durations;
+    }
+
+    //Precision of the samples as it is reported: the relative half-width of
+    //the confidence interval of the mean, from the bootstrap if enabled
+    double sample_precision(const std::vector<double>& durations){
+        if(!resamples || durations.size() < 2){
+            return relative_half_width(durations);
+        }
+
+        double mean = 0.0;
+
+        for(auto duration : durations){
+            mean += duration;
+        }
+
+        mean /= durations.size();
+
+        auto ci = bootstrap(durations, resamples, seed, [this](){ placement.release_worker(); });
+
+        return mean == 0.0 ? 0.0 : (ci.mean_ub - ci.mean_lb) / 2.0 / mean;
+    }
+
+    //Append count samples to the durations, less if expired() becomes true
+    template<typename Prepare, typename Call, typename Expired>
+    void take_samples(std::vector<double>& durations, std::size_t count, std::size_t batch, bool counting, Prepare& prepare, Call& call, Expired& expired){
+        auto first = durations.size();
+
+        durations.resize(first + count);
+
+        for(std::size_t i = first; i < durations.size(); ++i){
+            prepare();
+
+            if(cold_samples){
+                evictor.evict();
+            }
+
+            auto allocations = allocation_snapshot();
+
+            //The reads of the clock are counted, their counts are calibrated
+            if(counting){
+                counter_group.start();
+            }
+
+            auto start_time = Clock::start();
+            call(batch);
+
+            if(i == durations.size() - 1){
+                prologue();
+            }
+
+            auto end_time = Clock::stop();
+
+            if(counting){
+                counter_group.stop();
+            }
+
+            sample_allocations += allocation_snapshot() - allocations;
+
+            if(raw_samples){
+                sample_times.push_back(monitor.now());
+            }
+
+            durations[i] = Clock::ns(start_time, end_time);
+
+            if(expired()){
+                durations.resize(i + 1);
+                break;
+            }
+        }
+
+        for(std::size_t i = first; i < durations.size(); ++i){
+            if(subtract_overhead){
+                durations[i] = std::max(0.0, durations[i] - timer_overhead);
+            }
+
+            durations[i] /= batch;
+        }
+    }
+
+    //Measure the resolution of the clock and the overhead of an empty functor
+    //going through the same sampling code as the real measures
+
+    void calibrate_timer(){
+        timer_resolution = std::numeric_limits<double>::max();
+
+        for(std::size_t i = 0; i < 100; ++i){
+            auto start_time = Clock::start();
+
+            double elapsed;
+            do {
+                elapsed = Clock::ns(start_time, Clock::stop());
+            } while(elapsed <= 0.0);
+
+            timer_resolution = std::min(timer_resolution, elapsed);
+        }
+
+        //The calibration samples are taken raw, whatever the options of the
+        //measures: the timer may be calibrated again after they are set
+        auto subtract = subtract_overhead;
+        auto batched = batching;
+        auto target = precision;
+        auto raw = raw_samples;
+        auto cold = cold_samples;
+
+        subtract_overhead = false;
+        batching = false;
+        precision = 0.0;
+        raw_samples = false;
+        cold_samples = false;
+
+        auto empty = [](){};
+
+        auto durations = measure_samples(cpm::calibration_steps,
+            [](){},
+            [&empty](std::size_t batch){ call_batch(empty, batch); });
+
+        subtract_overhead = subtract;
+        batching = batched;
+        precision = target;
+        raw_samples = raw;
+        cold_samples = cold;
+
+        std::sort(durations.begin(), durations.end());
+
+        timer_overhead = durations[durations.size() / 2];
     }
 
     template<typename Config, typename Functor, typename Flops, typename... Args>
     measure_result measure_only_simple(const Config& conf, Functor&& functor, Flops&& flops, Args... args){
-        ++measures;
+        begin_measure();
 
         std::size_t steps = conf.steps;
 
@@ -1008,18 +2567,17 @@ private:
         double seconds = 0.0;
 
         while(true){
-            auto start_time = timer_clock::now();
+            auto start_time = Clock::start();
 
             for(std::size_t i = 0; i < steps; ++i){
-                call_functor(functor, args...);
+                call_batch(functor, 1, args...);
             }
 
             prologue();
 
-            auto end_time = timer_clock::now();
-            auto duration = std::chrono::duration_cast<clock_resolution>(end_time - start_time);
+            auto end_time = Clock::stop();
 
-            seconds = duration.count() / (1000.0 * 1000.0 * 1000.0);
+            seconds = Clock::ns(start_time, end_time) / (1000.0 * 1000.0 * 1000.0);
 
             if(seconds > cpm::step_estimation_min){
                 break;
@@ -1033,7 +2591,7 @@ private:
         //1. Warmup
 
         for(std::size_t i = 0; i < conf.warmup; ++i){
-            call_functor(functor, args...);
+            call_batch(functor, 1, args...);
         }
 
         prologue();
@@ -1041,33 +2599,20 @@ private:
         runs += conf.warmup;
 #endif
 
-        std::vector<std::size_t> durations(steps);
-
-        std::size_t i = 0;
-
-        for(; i < steps - 1; ++i){
-            auto start_time = timer_clock::now();
-            call_functor(functor, args...);
-            auto end_time = timer_clock::now();
-            auto duration = std::chrono::duration_cast<clock_resolution>(end_time - start_time);
-            durations[i] = duration.count();
-        }
+        cold_samples = conf.cold_cache;
 
-        auto start_time = timer_clock::now();
-        call_functor(functor, args...);
-        prologue();
-        auto end_time = timer_clock::now();
-        auto duration = std::chrono::duration_cast<clock_resolution>(end_time - start_time);
-        durations[i] = duration.count();
+        auto durations = measure_samples(steps,
+            [](){},
+            [&](std::size_t batch){ call_batch(functor, batch, args...); });
 
-        runs += steps;
+        runs += durations.size() * current_batch;
 
-        return measure(durations, call_flops(flops, args...));
+        return measure(durations, call_flops(flops_of(flops), args...), call_bytes(flops, args...));
     }
 
     template<bool Sizes, typename Config, typename Init, typename Functor, typename Flops, typename... Args>
     measure_result measure_only_two_pass(const Config& conf, Init&& init, Functor functor, Flops flops, Args... args){
-        ++measures;
+        begin_measure();
 
         auto data = call_init_functor(std::forward<Init>(init), args...);
 
@@ -1085,18 +2630,17 @@ private:
         double seconds = 0.0;
 
         while(true){
-            auto start_time = timer_clock::now();
+            auto start_time = Clock::start();
 
             for(std::size_t i = 0; i < steps; ++i){
-                call_with_data<Sizes>(data, functor, sequence, args...);
+                call_batch_with_data<Sizes>(data, functor, sequence, 1, args...);
             }
 
             prologue();
 
-            auto end_time = timer_clock::now();
-            auto duration = std::chrono::duration_cast<clock_resolution>(end_time - start_time);
+            auto end_time = Clock::stop();
 
-            seconds = duration.count() / (1000.0 * 1000.0 * 1000.0);
+            seconds = Clock::ns(start_time, end_time) / (1000.0 * 1000.0 * 1000.0);
 
             if(seconds > cpm::step_estimation_min){
                 break;
@@ -1111,7 +2655,7 @@ private:
 
         for(std::size_t i = 0; i < conf.warmup; ++i){
             randomize_each(data, sequence);
-            call_with_data<Sizes>(data, functor, sequence, args...);
+            call_batch_with_data<Sizes>(data, functor, sequence, 1, args...);
         }
 
         prologue();
@@ -1123,35 +2667,20 @@ private:
 
         random_init_each(data, sequence);
 
-        std::vector<std::size_t> durations(steps);
+        cold_samples = conf.cold_cache;
 
-        std::size_t i = 0;
+        auto durations = measure_samples(steps,
+            [&](){ randomize_each(data, sequence); },
+            [&](std::size_t batch){ call_batch_with_data<Sizes>(data, functor, sequence, batch, args...); });
 
-        for(; i < steps - 1; ++i){
-            randomize_each(data, sequence);
-            auto start_time = timer_clock::now();
-            call_with_data<Sizes>(data, functor, sequence, args...);
-            auto end_time = timer_clock::now();
-            auto duration = std::chrono::duration_cast<clock_resolution>(end_time - start_time);
-            durations[i] = duration.count();
-        }
+        runs += durations.size() * current_batch;
 
-        randomize_each(data, sequence);
-        auto start_time = timer_clock::now();
-        call_with_data<Sizes>(data, functor, sequence, args...);
-        prologue();
-        auto end_time = timer_clock::now();
-        auto duration = std::chrono::duration_cast<clock_resolution>(end_time - start_time);
-        durations[i] = duration.count();
-
-        runs += steps;
-
-        return measure(durations, call_flops(flops, args...));
+        return measure(durations, call_flops(flops_of(flops), args...), call_bytes(flops, args...));
     }
 
     template<typename Config, typename Functor, typename Flops, typename Tuple, typename... T>
     measure_result measure_only_global(const Config& conf, Functor&& functor, Flops&& flops, Tuple d, T&... references){
-        ++measures;
+        begin_measure();
 
         //0. Initialization
 
@@ -1164,18 +2693,17 @@ private:
         double seconds = 0.0;
 
         while(true){
-            auto start_time = timer_clock::now();
+            auto start_time = Clock::start();
 
             for(std::size_t i = 0; i < steps; ++i){
-                call_functor(functor, d);
+                call_batch(functor, 1, d);
             }
 
             prologue();
 
-            auto end_time = timer_clock::now();
-            auto duration = std::chrono::duration_cast<clock_resolution>(end_time - start_time);
+            auto end_time = Clock::stop();
 
-            seconds = duration.count() / (1000.0 * 1000.0 * 1000.0);
+            seconds = Clock::ns(start_time, end_time) / (1000.0 * 1000.0 * 1000.0);
 
             if(seconds > cpm::step_estimation_min){
                 break;
@@ -1191,7 +2719,7 @@ private:
         for(std::size_t i = 0; i < conf.warmup; ++i){
             using cpm::randomize;
             randomize(references...);
-            call_functor(functor, d);
+            call_batch(functor, 1, d);
         }
 
         prologue();
@@ -1203,37 +2731,141 @@ private:
 
         random_init(references...);
 
-        std::vector<std::size_t> durations(steps);
+        cold_samples = conf.cold_cache;
 
-        std::size_t i = 0;
+        auto durations = measure_samples(steps,
+            [&](){ using cpm::randomize; randomize(references...); },
+            [&](std::size_t batch){ call_batch(functor, batch, d); });
 
-        for(; i < steps; ++i){
-            using cpm::randomize;
-            randomize(references...);
-            auto start_time = timer_clock::now();
-            call_functor(functor, d);
-            auto end_time = timer_clock::now();
-            auto duration = std::chrono::duration_cast<clock_resolution>(end_time - start_time);
-            durations[i] = duration.count();
+        runs += durations.size() * current_batch;
+
+        return measure(durations, call_flops(flops_of(flops), d), call_bytes(flops, d));
+    }
+
+    //The workers are released together by a barrier for each sample. The
+    //latency of each call is measured by its thread and the wall time of
+    //a sample goes from the first start to the last end
+
+    template<typename Config, typename Functor, typename Flops, typename Sizes>
+    measure_result measure_only_parallel(const Config& conf, Functor& functor, Flops& flops, Sizes d){
+        begin_measure();
+
+        const std::size_t threads = thread_count(d);
+        const std::size_t warmup = conf.warmup;
+        const std::size_t steps = std::max(std::size_t(1), conf.steps);
+        const std::size_t iterations = warmup + steps;
+
+        //Time points are stored relatively to a reference taken before each release
+        std::vector<typename Clock::time_point> reference(iterations);
+        std::vector<std::vector<double>> starts(threads, std::vector<double>(iterations));
+        std::vector<std::vector<double>> ends(threads, std::vector<double>(iterations));
+
+        std::barrier<> sync(threads + 1);
+
+        //The workers are counted with the rest of the process, and their creation with them
+        auto resources = read_resource_usage(false);
+
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+
+        for(std::size_t t = 0; t < threads; ++t){
+            workers.emplace_back([&, t](){
+                placement.release_worker();
+
+                for(std::size_t i = 0; i < iterations; ++i){
+                    sync.arrive_and_wait();
+
+                    auto start_time = Clock::start();
+                    call_parallel(functor, t, d);
+
+                    if(i == iterations - 1){
+                        prologue();
+                    }
+
+                    auto end_time = Clock::stop();
+
+                    starts[t][i] = Clock::ns(reference[i], start_time);
+                    ends[t][i] = Clock::ns(reference[i], end_time);
+
+                    sync.arrive_and_wait();
+                }
+            });
         }
 
-        using cpm::randomize;
-        randomize(references...);
-        auto start_time = timer_clock::now();
-        call_functor(functor, d);
-        prologue();
-        auto end_time = timer_clock::now();
-        auto duration = std::chrono::duration_cast<clock_resolution>(end_time - start_time);
-        durations[i] = duration.count();
+        for(std::size_t i = 0; i < iterations; ++i){
+            reference[i] = Clock::start();
+
+            //Release the workers and wait for all of them to finish
+            sync.arrive_and_wait();
+            sync.arrive_and_wait();
+        }
 
-        runs += steps;
+        for(auto& worker : workers){
+            worker.join();
+        }
+
+        sample_resources = resource_difference(resources, read_resource_usage(false));
+
+        runs += iterations * threads;
+
+        std::vector<double> durations;
+        durations.reserve(steps * threads);
+
+        parallel_result parallel;
+        parallel.threads = threads;
+        parallel.work = work_size(d);
+
+        for(std::size_t t = 0; t < threads; ++t){
+            std::vector<double> thread_durations(steps);
+
+            for(std::size_t i = 0; i < steps; ++i){
+                auto duration = ends[t][warmup + i] - starts[t][warmup + i];
+
+                if(subtract_overhead){
+                    duration = std::max(0.0, duration - timer_overhead);
+                }
+
+                thread_durations[i] = duration;
+            }
+
+            durations.insert(durations.end(), thread_durations.begin(), thread_durations.end());
+            parallel.per_thread.push_back(thread_stats(thread_durations));
+        }
+
+        double wall = 0.0;
+
+        for(std::size_t i = warmup; i < iterations; ++i){
+            double first = starts[0][i];
+            double last = ends[0][i];
 
-        return measure(durations, call_flops(flops, d));
+            for(std::size_t t = 1; t < threads; ++t){
+                first = std::min(first, starts[t][i]);
+                last = std::max(last, ends[t][i]);
+            }
+
+            wall += last - first;
+        }
+
+        parallel.wall = wall / steps;
+        parallel.throughput = wall == 0.0 ? 0.0 : (steps * threads) / (wall / (1000.0 * 1000.0 * 1000.0));
+        parallel.fairness = jain_fairness(parallel.per_thread);
+
+        //Neither batching nor hardware counters apply to the worker threads
+        current_batch = 1;
+
+        auto result = measure(durations, call_flops(flops_of(flops), d), call_bytes(flops, d));
+        result.counters = {};
+        result.parallel = std::move(parallel);
+
+        return result;
     }
 
     template<typename Tuple>
     void report(const std::string& title, Tuple d, measure_result& duration){
-        duration.update(size_to_eff(d));
+        //The threads of a parallel measure are not part of its size
+        duration.update(duration.parallel.threads ? parallel_size(d) : size_to_eff(d));
+
+        check_allocations(allocation_free, false, title + "(" + size_to_string(d) + ")", duration);
 
         if(standard_report){
             std::cout << title << "(" << size_to_string(d) << "): "
@@ -1242,9 +2874,105 @@ private:
                 << " stddev:" << duration_str(duration.stddev, 3)
                 << " min:" << duration_str(duration.min, 3)
                 << " max:" << duration_str(duration.max, 3)
+                << " median:" << duration_str(duration.robust.median, 3)
+                << " p99:" << duration_str(duration.robust.p99, 3)
                 << " (" << throughput_str(duration.throughput_e, 3) << "Es"
-                << "," << throughput_str(duration.throughput_f, 3) << "Flop/s)"
-                << "\n";
+                << "," << throughput_str(duration.throughput_f, 3) << "Flop/s";
+
+            if(duration.bytes){
+                std::cout << "," << throughput_str(duration.throughput_b, 3) << "B/s"
+                    << ", " << to_string_precision(duration.intensity, 3) << "Flop/B";
+            }
+
+            std::cout << ")";
+
+            if(duration.batch > 1){
+                std::cout << " batch:" << duration.batch;
+            }
+
+            if(duration.robust.mild_outliers || duration.robust.severe_outliers){
+                std::cout << " outliers:" << duration.robust.mild_outliers << "+" << duration.robust.severe_outliers;
+            }
+
+            //The parallel measures take a fixed number of samples
+            if(precision > 0.0 && !duration.parallel.threads){
+                std::cout << " samples:" << duration.samples << " +/-" << to_string_precision(duration.precision * 100.0, 3) << "%";
+
+                if(duration.precision > precision){
+                    std::cout << " (imprecise)";
+                }
+            }
+
+            if(duration.unreliable){
+                std::cout << " (unreliable)";
+            }
+
+            if(duration.allocations.tracked){
+                std::cout << " allocs:" << to_string_precision(duration.allocations.allocations, 3)
+                    << "/" << to_string_precision(duration.allocations.deallocations, 3)
+                    << " (" << throughput_str(duration.allocations.bytes, 3) << "B)";
+            }
+
+            if(duration.resources.minor_faults > 0.0 || duration.resources.major_faults > 0.0){
+                std::cout << " faults:" << duration.resources.minor_faults << "+" << duration.resources.major_faults;
+            }
+
+            if(duration.resources.involuntary_switches > 0.0){
+                std::cout << " preempted:" << duration.resources.involuntary_switches;
+            }
+
+            //The sampling thread does not exist in an isolated bench
+            if(monitor.running() && parent_fd < 0){
+                auto system = monitor.summary(duration.start, duration.end);
+
+                if(system.throttled){
+                    std::cout << " (throttled)";
+                }
+
+                if(system.loaded){
+                    std::cout << " (loaded)";
+                }
+            }
+
+            if(duration.parallel.threads){
+                std::cout << " threads:" << duration.parallel.threads
+                    << " (" << throughput_str(duration.parallel.throughput, 3) << "ops/s"
+                    << ", fairness:" << to_string_precision(duration.parallel.fairness, 3) << ")";
+            }
+
+            if(duration.counters.available()){
+                //Misses are reported per functor call
+                std::string sep = " [";
+
+                if(duration.counters.has(counter_event::CYCLES) && duration.counters.has(counter_event::INSTRUCTIONS)){
+                    std::cout << sep << "IPC:" << to_string_precision(duration.counters.ipc(), 3);
+                    sep = " ";
+                } else if(duration.counters.has(counter_event::CYCLES)){
+                    std::cout << sep << "Cycles:" << throughput_str(duration.counters.get(counter_event::CYCLES), 3);
+                    sep = " ";
+                } else if(duration.counters.has(counter_event::INSTRUCTIONS)){
+                    std::cout << sep << "Instructions:" << throughput_str(duration.counters.get(counter_event::INSTRUCTIONS), 3);
+                    sep = " ";
+                }
+
+                if(duration.counters.has(counter_event::L1D_MISSES)){
+                    std::cout << sep << "L1D:" << throughput_str(duration.counters.get(counter_event::L1D_MISSES), 3);
+                    sep = " ";
+                }
+
+                if(duration.counters.has(counter_event::LLC_MISSES)){
+                    std::cout << sep << "LLC:" << throughput_str(duration.counters.get(counter_event::LLC_MISSES), 3);
+                    sep = " ";
+                }
+
+                if(duration.counters.has(counter_event::BRANCH_MISSES)){
+                    std::cout << sep << "BR:" << throughput_str(duration.counters.get(counter_event::BRANCH_MISSES), 3);
+                }
+
+                std::cout << "]";
+            }
+
+            std::cout << "\n";
         }
     }
 };
@@ -15,12 +15,32 @@ namespace cpm {
 struct cpm_registry {
     cpm_registry(void (*function)(cpm::benchmark<>&)){
         benchs().emplace_back(function);
+        exclusives().push_back(next_exclusive());
+        next_exclusive() = false;
     }
 
     static std::vector<void(*)(cpm::benchmark<>&)>& benchs(){
         static std::vector<void(*)(cpm::benchmark<>&)> vec;
         return vec;
     }
+
+    //The benchs that must not run concurrently with other benchs
+    static std::vector<bool>& exclusives(){
+        static std::vector<bool> vec;
+        return vec;
+    }
+
+    static bool& next_exclusive(){
+        static bool exclusive = false;
+        return exclusive;
+    }
+};
+
+//Mark the next registered bench as exclusive
+struct cpm_exclusive {
+    cpm_exclusive(){
+        cpm_registry::next_exclusive() = true;
+    }
 };
 
 template<template<typename...> class TT, typename T>
@@ -42,6 +62,11 @@ struct is_section : is_specialization_of<cpm::section, std::decay_t<T>> {};
 
 //Declarations of benchs functions
 
+//Must be placed before a bench or a section that must run alone (memory
+//bandwidth, multi-threaded, ...) when several benchs run concurrently
+#define CPM_EXCLUSIVE() \
+    namespace { cpm::cpm_exclusive CPM_UNIQUE_NAME(exclusive_); }
+
 #define CPM_BENCH()  \
     static void CPM_UNIQUE_NAME(bench_) (cpm::benchmark<>& bench); \
     namespace { cpm::cpm_registry CPM_UNIQUE_NAME(register_) (& CPM_UNIQUE_NAME(bench_)); }              \
@@ -111,12 +136,13 @@ struct is_section : is_specialization_of<cpm::section, std::decay_t<T>> {};
 #define CPM_GLOBAL_F(...) bench.measure_global_flops(__VA_ARGS__)
 #define CPM_TWO_PASS(...) bench.measure_two_pass(__VA_ARGS__)
 #define CPM_TWO_PASS_NS(...) bench.measure_two_pass<false>(__VA_ARGS__)
+#define CPM_PARALLEL(...) bench.measure_parallel(__VA_ARGS__)
 
 //Versions with policies
 
 #define CPM_SIMPLE_P(policy, ...)  \
     static_assert(!cpm::is_section<decltype(bench)>::value, "CPM_SIMPLE_P cannot be used inside CPM_SECTION");  \
-    bench.measure_simple<policy>(__VA_ARGS__)g 
+    bench.measure_simple<policy>(__VA_ARGS__)
 
 #define CPM_GLOBAL_P(policy, ...) \
     static_assert(!cpm::is_section<decltype(bench)>::value, "CPM_GLOBAL_P cannot be used inside CPM_SECTION");  \
@@ -134,6 +160,10 @@ struct is_section : is_specialization_of<cpm::section, std::decay_t<T>> {};
     static_assert(!cpm::is_section<decltype(bench)>::value, "CPM_TWO_PASS_NS_P cannot be used inside CPM_SECTION");  \
     bench.measure_two_pass<false, policy>(__VA_ARGS__)
 
+#define CPM_PARALLEL_P(policy, ...)  \
+    static_assert(!cpm::is_section<decltype(bench)>::value, "CPM_PARALLEL_P cannot be used inside CPM_SECTION");  \
+    bench.measure_parallel<policy>(__VA_ARGS__)
+
 //Direct bench functions
 
 #define CPM_DIRECT_BENCH_SIMPLE(...) CPM_BENCH() { CPM_SIMPLE(__VA_ARGS__); }
@@ -227,6 +257,10 @@ struct is_section : is_specialization_of<cpm::section, std::decay_t<T>> {};
 #define POLICY(...) __VA_ARGS__
 #define VALUES_POLICY(...) cpm::values_policy<__VA_ARGS__>
 #define NARY_POLICY(...) cpm::simple_nary_policy<__VA_ARGS__>
+#define CONSTANT_POLICY(S) cpm::constant_policy<S> //Only one measure outside of NARY_POLICY
+#define THREADS_POLICY(...) cpm::threads_policy<__VA_ARGS__>
+#define STRONG_SCALING_POLICY(...) cpm::strong_scaling_policy<__VA_ARGS__>
+#define WEAK_SCALING_POLICY(...) cpm::weak_scaling_policy<__VA_ARGS__>
 #define STD_STOP_POLICY cpm::std_stop_policy
 #define STOP_POLICY(start, stop, add, mul) cpm::increasing_policy<start, stop, add, mul, stop_policy::STOP>
 #define TIMEOUT_POLICY(start, stop, add, mul) cpm::increasing_policy<start, stop, add, mul, stop_policy::TIMEOUT>
@@ -247,6 +281,32 @@ int main(int argc, char* argv[]){
             ("o,output", "Output folder", cxxopts::value<std::string>())
             ("f,oneshot", "Don't save result")
             ("mflops", "Print section summary with MFlops/s")
+            ("counters", "Read hardware performance counters around each sample")
+            ("subtract-overhead", "Subtract the calibrated timer overhead from each sample")
+            ("batch", "Time batches of calls so that each sample lasts long enough")
+            ("precision", "Sample until the confidence interval of the mean is within this fraction of the mean (0.01 for 1%)", cxxopts::value<double>())
+            ("min-steps", "Minimum number of samples with a target precision", cxxopts::value<std::size_t>())
+            ("max-steps", "Maximum number of samples with a target precision", cxxopts::value<std::size_t>())
+            ("max-time", "Maximum seconds of sampling of a measure with a target precision", cxxopts::value<double>())
+            ("histogram-digits", "Significant digits of the latency histograms, 0 to disable", cxxopts::value<std::size_t>())
+            ("raw-samples", "Save every sample in a binary file next to the results")
+            ("cold", "Evict the caches before each sample")
+            ("peaks", "Calibrate the peak bandwidth and flops of the machine (cached) and save them with the results")
+            ("recalibrate", "Calibrate the peaks even if they are cached")
+            ("peaks-file", "Cache file of the peaks", cxxopts::value<std::string>())
+            ("binary", "Save the results in the binary columnar format (.cpmb) instead of JSON")
+            ("allocation-free", "Fail the measures whose functor allocates (needs CPM_TRACK_ALLOCATIONS)")
+            ("resamples", "Bootstrap resamples of the confidence intervals, 0 for the normal approximation", cxxopts::value<std::size_t>())
+            ("seed", "Seed of the bootstrap", cxxopts::value<std::size_t>())
+            ("cpu", "Pin the measuring thread to the given cpu", cxxopts::value<int>())
+            ("idle-sibling", "Keep the SMT siblings of the pinned cpu free")
+            ("fifo", "Use the SCHED_FIFO scheduler for the measuring thread if permitted")
+            ("nice", "Nice value of the benchmark", cxxopts::value<int>())
+            ("mlock", "Lock the memory of the benchmark if permitted")
+            ("monitor", "Sample the state of the machine during the run")
+            ("isolate", "Run each bench in its own process")
+            ("timeout", "Maximum duration of an isolated bench in seconds", cxxopts::value<double>())
+            ("slots", "Number of benchs running concurrently, each isolated on its own core", cxxopts::value<std::size_t>())
             ("filter", "Filter tests/sections to run", cxxopts::value<std::string>())
             ("h,help", "Print help")
             ;
@@ -309,12 +369,119 @@ int main(int argc, char* argv[]){
             bench.section_mflops = true;
         }
 
-        bench.begin();
+        if(result.count("counters")){
+            bench.hardware_counters = true;
+        }
+
+        if(result.count("subtract-overhead")){
+            bench.subtract_overhead = true;
+        }
+
+        if(result.count("batch")){
+            bench.batching = true;
+        }
+
+        if(result.count("precision")){
+            bench.precision = result["precision"].as<double>();
+        }
+
+        if(result.count("min-steps")){
+            bench.min_steps = result["min-steps"].as<std::size_t>();
+        }
+
+        if(result.count("max-steps")){
+            bench.max_steps = result["max-steps"].as<std::size_t>();
+        }
+
+        if(result.count("max-time")){
+            bench.max_time = result["max-time"].as<double>();
+        }
+
+        if(result.count("histogram-digits")){
+            bench.histogram_digits = result["histogram-digits"].as<std::size_t>();
+        }
+
+        if(result.count("raw-samples")){
+            bench.raw_samples = true;
+        }
+
+        if(result.count("cold")){
+            bench.cold_cache = true;
+        }
+
+        if(result.count("peaks")){
+            bench.peaks = true;
+        }
 
-        for(auto f : cpm::cpm_registry::benchs()){
-            f(bench);
+        if(result.count("recalibrate")){
+            bench.peaks = true;
+            bench.recalibrate = true;
         }
 
+        if(result.count("peaks-file")){
+            bench.peaks_file = result["peaks-file"].as<std::string>();
+        }
+
+        if(result.count("binary")){
+            bench.binary = true;
+        }
+
+        if(result.count("allocation-free")){
+            bench.allocation_free = true;
+        }
+
+        if(result.count("resamples")){
+            bench.resamples = result["resamples"].as<std::size_t>();
+        }
+
+        if(result.count("seed")){
+            bench.seed = result["seed"].as<std::size_t>();
+        }
+
+        if(result.count("cpu")){
+            bench.pin_cpu = result["cpu"].as<int>();
+        }
+
+        if(result.count("idle-sibling")){
+            bench.idle_sibling = true;
+        }
+
+        if(result.count("fifo")){
+            bench.realtime = true;
+        }
+
+        if(result.count("nice")){
+            bench.nice = result["nice"].as<int>();
+        }
+
+        if(result.count("mlock")){
+            bench.lock_memory = true;
+        }
+
+        if(result.count("monitor")){
+            bench.monitor_system = true;
+        }
+
+        if(result.count("isolate")){
+            bench.isolate = true;
+        }
+
+        if(result.count("timeout")){
+            bench.timeout = result["timeout"].as<double>();
+        }
+
+        if(result.count("slots")){
+            bench.slots = result["slots"].as<std::size_t>();
+        }
+
+        bench.begin();
+
+        bench.run_all(cpm::cpm_registry::benchs(), cpm::cpm_registry::exclusives());
+
+        //The results are saved, but the run must be seen as failed
+        if(bench.failed()){
+            return 1;
+        }
     } catch (const cxxopts::OptionException& e){
         std::cout << "cpm: error parsing options: " << e.what() << std::endl;
         return -1;
@@ -20,6 +20,7 @@ struct reports_data {
     std::set<std::string> compilers;
     std::set<std::string> configurations;
     std::vector<document_t> documents;
+    std::vector<document_t> baselines; //Runs of --baseline-file, compared with but not part of the history
 
     //Temporary data (changed for each generated file)
     std::string file;
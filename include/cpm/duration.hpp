@@ -11,8 +11,14 @@
 #include <chrono>
 #include <ctime>
 #include <iomanip>
+#include <vector>
 
+#include "allocations.hpp"
 #include "compat.hpp"
+#include "counters.hpp"
+#include "parallel.hpp"
+#include "resources.hpp"
+#include "statistics.hpp"
 
 namespace cpm {
 
@@ -35,10 +41,30 @@ struct measure_result {
     double throughput_e;
     double throughput_f;
     std::size_t flops;
+    counters_result counters;
+    bool unreliable = false; //Too close to the clock resolution
+    std::size_t batch = 1;   //Number of calls per sample
+    parallel_result parallel{}; //Only filled by parallel measures
+    double start = 0.0;         //seconds since the start of the system monitor
+    double end = 0.0;
+    robust_result robust{};     //Order statistics of the samples
+    std::size_t samples = 0;
+    double precision = 0.0;     //Half-width of the confidence interval of the mean relative to the mean
+    std::string histogram{};    //Encoded log-linear histogram of the samples
+    std::vector<double> raw_durations{}; //Only kept when the raw samples are saved
+    std::vector<double> raw_times{};     //End of each sample, seconds since the start of the system monitor
+    allocation_result allocations{};     //Heap operations per call in the timed region
+    resource_result resources{};         //Faults and context switches of the whole sampling
+    bool cold = false;                   //The caches were evicted before each sample
+    std::size_t bytes = 0;               //Bytes moved by a call, 0 if unknown
+    double throughput_b = 0.0;           //Bytes per second
+    double intensity = 0.0;              //Flops per byte moved
 
     cpp14_constexpr void update(std::size_t size_eff){
         throughput_e = mean == 0.0 ? 0.0 : size_eff / (mean / (1000.0 * 1000.0 * 1000.0));
         throughput_f = mean == 0.0 ? 0.0 : flops / (mean / (1000.0 * 1000.0 * 1000.0));
+        throughput_b = mean == 0.0 ? 0.0 : bytes / (mean / (1000.0 * 1000.0 * 1000.0));
+        intensity = bytes == 0 ? 0.0 : static_cast<double>(flops) / bytes;
     }
 };
 
@@ -0,0 +1,215 @@
+//=======================================================================
+// Copyright (c) 2015-2016 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef CPM_HISTOGRAM_HPP
+#define CPM_HISTOGRAM_HPP
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <bit>
+
+namespace cpm {
+
+//Log-linear histogram of the samples (HDR style): the values are counted in
+//picoseconds, exactly below 2 * 10^digits and then in buckets whose width
+//doubles with each power of two, so that every bucket keeps the given
+//number of significant digits
+
+static constexpr const double histogram_unit = 1000.0; //values per ns
+static constexpr const uint64_t histogram_version = 1;
+
+struct histogram_bucket {
+    double low;  //ns
+    double high; //ns, exclusive
+    uint64_t count;
+};
+
+//Number of bits of the linear part of the histogram
+inline std::size_t histogram_sub_bits(std::size_t digits){
+    uint64_t largest = 2;
+    for(std::size_t i = 0; i < digits; ++i){
+        largest *= 10;
+    }
+
+    return std::bit_width(largest - 1);
+}
+
+inline uint64_t histogram_index(uint64_t value, std::size_t sub_bits){
+    const uint64_t sub_count = uint64_t(1) << sub_bits;
+
+    if(value < sub_count){
+        return value;
+    }
+
+    //The highest sub_bits bits of the value select the sub-bucket
+    const uint64_t magnitude = std::bit_width(value) - sub_bits;
+
+    return sub_count + (magnitude - 1) * (sub_count / 2) + ((value >> magnitude) - sub_count / 2);
+}
+
+//Lowest value of a bucket and lowest value of the next one
+inline std::pair<uint64_t, uint64_t> histogram_range(uint64_t index, std::size_t sub_bits){
+    const uint64_t sub_count = uint64_t(1) << sub_bits;
+
+    if(index < sub_count){
+        return {index, index + 1};
+    }
+
+    auto magnitude = (index - sub_count) / (sub_count / 2) + 1;
+    auto sub = (index - sub_count) % (sub_count / 2) + sub_count / 2;
+
+    return {sub << magnitude, (sub + 1) << magnitude};
+}
+
+inline void write_varint(std::string& out, uint64_t value){
+    while(value >= 0x80){
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+
+    out.push_back(static_cast<char>(value));
+}
+
+inline bool read_varint(const std::string& in, std::size_t& position, uint64_t& value){
+    value = 0;
+
+    for(std::size_t shift = 0; position < in.size() && shift < 64; shift += 7){
+        auto byte = static_cast<unsigned char>(in[position++]);
+        value |= uint64_t(byte & 0x7F) << shift;
+
+        if(!(byte & 0x80)){
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static constexpr const char* base64_chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+inline std::string base64_encode(const std::string& in){
+    std::string out;
+
+    for(std::size_t i = 0; i < in.size(); i += 3){
+        uint32_t block = uint32_t(static_cast<unsigned char>(in[i])) << 16;
+
+        if(i + 1 < in.size()){
+            block |= uint32_t(static_cast<unsigned char>(in[i + 1])) << 8;
+        }
+
+        if(i + 2 < in.size()){
+            block |= uint32_t(static_cast<unsigned char>(in[i + 2]));
+        }
+
+        out.push_back(base64_chars[(block >> 18) & 0x3F]);
+        out.push_back(base64_chars[(block >> 12) & 0x3F]);
+        out.push_back(i + 1 < in.size() ? base64_chars[(block >> 6) & 0x3F] : '=');
+        out.push_back(i + 2 < in.size() ? base64_chars[block & 0x3F] : '=');
+    }
+
+    return out;
+}
+
+inline std::string base64_decode(const std::string& in){
+    std::string out;
+
+    uint32_t block = 0;
+    std::size_t bits = 0;
+
+    for(auto c : in){
+        const char* p = std::char_traits<char>::find(base64_chars, 64, c);
+
+        if(!p){
+            continue;
+        }
+
+        block = (block << 6) | uint32_t(p - base64_chars);
+        bits += 6;
+
+        if(bits >= 8){
+            bits -= 8;
+            out.push_back(static_cast<char>((block >> bits) & 0xFF));
+        }
+    }
+
+    return out;
+}
+
+//Encoded histogram: version, digits and then the non-empty buckets as
+//(index delta, count) varints, in base64 to fit in the document
+inline std::string encode_histogram(const std::vector<double>& durations, std::size_t digits){
+    //More digits than the clock can resolve are meaningless
+    digits = std::min(digits, std::size_t(6));
+
+    const auto sub_bits = histogram_sub_bits(digits);
+
+    std::vector<uint64_t> indices;
+    indices.reserve(durations.size());
+
+    for(auto duration : durations){
+        indices.push_back(histogram_index(static_cast<uint64_t>(std::llround(std::max(0.0, duration) * histogram_unit)), sub_bits));
+    }
+
+    std::sort(indices.begin(), indices.end());
+
+    std::string raw;
+    write_varint(raw, histogram_version);
+    write_varint(raw, digits);
+
+    uint64_t previous = 0;
+
+    for(std::size_t i = 0; i < indices.size();){
+        std::size_t j = i;
+        while(j < indices.size() && indices[j] == indices[i]){
+            ++j;
+        }
+
+        write_varint(raw, indices[i] - previous);
+        write_varint(raw, j - i);
+
+        previous = indices[i];
+        i = j;
+    }
+
+    return base64_encode(raw);
+}
+
+inline std::vector<histogram_bucket> decode_histogram(const std::string& encoded){
+    std::vector<histogram_bucket> buckets;
+
+    auto raw = base64_decode(encoded);
+
+    std::size_t position = 0;
+    uint64_t version = 0;
+    uint64_t digits = 0;
+
+    if(!read_varint(raw, position, version) || version != histogram_version || !read_varint(raw, position, digits)){
+        return buckets;
+    }
+
+    const auto sub_bits = histogram_sub_bits(std::min(digits, uint64_t(6)));
+
+    uint64_t index = 0;
+    uint64_t delta = 0;
+    uint64_t count = 0;
+
+    while(read_varint(raw, position, delta) && read_varint(raw, position, count)){
+        index += delta;
+
+        auto range = histogram_range(index, sub_bits);
+        buckets.push_back({range.first / histogram_unit, range.second / histogram_unit, count});
+    }
+
+    return buckets;
+}
+
+} //end of namespace cpm
+
+#endif //CPM_HISTOGRAM_HPP
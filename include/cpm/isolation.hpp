@@ -0,0 +1,323 @@
+//=======================================================================
+// Copyright (c) 2015-2016 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef CPM_ISOLATION_HPP
+#define CPM_ISOLATION_HPP
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <cerrno>
+#include <type_traits>
+
+#include <unistd.h>
+#include <poll.h>
+#include <sys/types.h>
+
+#include "duration.hpp"
+
+namespace cpm {
+
+//A bench or a section that did not complete in its isolated process
+struct failure_data {
+    std::string title;
+    bool section;
+    std::string reason;
+};
+
+//Messages sent by an isolated bench to the parent process
+enum class message_type : char {
+    BENCH_STARTED = 'B',
+    SECTION_STARTED = 'S',
+    BENCH_RESULT = 'R',
+    SECTION_RESULT = 'T',
+    STATISTICS = 'E',
+    ERROR = 'F',
+    FAILURE = 'A' //Failed assertion of a measure, its results are kept
+};
+
+//Binary encoding of the messages, only used between a process and its fork
+struct message_writer {
+    std::string buffer;
+
+    template<typename T>
+    void value(const T& value){
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be written directly");
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void value(const std::string& value){
+        this->value(uint64_t(value.size()));
+        buffer.append(value);
+    }
+
+    template<typename T>
+    void value(const std::vector<T>& values){
+        this->value(uint64_t(values.size()));
+        for(auto& v : values){
+            this->value(v);
+        }
+    }
+
+    void value(const measure_result& result){
+        value(result.mean);
+        value(result.mean_lb);
+        value(result.mean_ub);
+        value(result.stddev);
+        value(result.min);
+        value(result.max);
+        value(result.throughput_e);
+        value(result.throughput_f);
+        value(result.flops);
+        value(result.counters);
+        value(result.unreliable);
+        value(result.batch);
+        value(result.parallel.threads);
+        value(result.parallel.work);
+        value(result.parallel.wall);
+        value(result.parallel.throughput);
+        value(result.parallel.fairness);
+        value(result.parallel.per_thread);
+        value(result.start);
+        value(result.end);
+        value(result.robust);
+        value(result.samples);
+        value(result.precision);
+        value(result.histogram);
+        value(result.raw_durations);
+        value(result.raw_times);
+        value(result.allocations);
+        value(result.resources);
+        value(result.cold);
+        value(result.bytes);
+        value(result.throughput_b);
+        value(result.intensity);
+    }
+
+    //Send the message on the file descriptor, the message is lost if the parent is gone
+    void send(int fd, message_type type){
+        std::string frame;
+        frame.push_back(static_cast<char>(type));
+
+        uint64_t size = buffer.size();
+        frame.append(reinterpret_cast<const char*>(&size), sizeof(size));
+        frame.append(buffer);
+
+        std::size_t written = 0;
+        while(written < frame.size()){
+            auto n = ::write(fd, frame.data() + written, frame.size() - written);
+
+            if(n < 0 && errno == EINTR){
+                continue;
+            } else if(n <= 0){
+                break;
+            }
+
+            written += n;
+        }
+
+        buffer.clear();
+    }
+};
+
+struct message_reader {
+    const std::string& buffer;
+    std::size_t position;
+    std::size_t end;
+
+    bool good() const {
+        return position <= end;
+    }
+
+    template<typename T>
+    void value(T& value){
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be read directly");
+
+        if(position + sizeof(T) > end){
+            position = end + 1;
+            return;
+        }
+
+        std::memcpy(&value, buffer.data() + position, sizeof(T));
+        position += sizeof(T);
+    }
+
+    void value(std::string& value){
+        uint64_t size = 0;
+        this->value(size);
+
+        if(!good() || position + size > end){
+            position = end + 1;
+            return;
+        }
+
+        value.assign(buffer.data() + position, size);
+        position += size;
+    }
+
+    template<typename T>
+    void value(std::vector<T>& values){
+        uint64_t size = 0;
+        this->value(size);
+
+        values.clear();
+
+        for(uint64_t i = 0; i < size && good(); ++i){
+            values.emplace_back();
+            this->value(values.back());
+        }
+    }
+
+    void value(measure_result& result){
+        value(result.mean);
+        value(result.mean_lb);
+        value(result.mean_ub);
+        value(result.stddev);
+        value(result.min);
+        value(result.max);
+        value(result.throughput_e);
+        value(result.throughput_f);
+        value(result.flops);
+        value(result.counters);
+        value(result.unreliable);
+        value(result.batch);
+        value(result.parallel.threads);
+        value(result.parallel.work);
+        value(result.parallel.wall);
+        value(result.parallel.throughput);
+        value(result.parallel.fairness);
+        value(result.parallel.per_thread);
+        value(result.start);
+        value(result.end);
+        value(result.robust);
+        value(result.samples);
+        value(result.precision);
+        value(result.histogram);
+        value(result.raw_durations);
+        value(result.raw_times);
+        value(result.allocations);
+        value(result.resources);
+        value(result.cold);
+        value(result.bytes);
+        value(result.throughput_b);
+        value(result.intensity);
+    }
+};
+
+//Complete message found in the stream of a process
+struct message {
+    message_type type;
+    std::size_t begin; //position of the payload in the stream
+    std::size_t end;
+};
+
+//Split the stream in messages, an incomplete message at the end is ignored
+inline std::vector<message> split_messages(const std::string& stream){
+    std::vector<message> messages;
+
+    std::size_t position = 0;
+
+    while(position + 1 + sizeof(uint64_t) <= stream.size()){
+        uint64_t size;
+        std::memcpy(&size, stream.data() + position + 1, sizeof(size));
+
+        auto begin = position + 1 + sizeof(uint64_t);
+
+        if(begin + size > stream.size()){
+            break;
+        }
+
+        messages.push_back({static_cast<message_type>(stream[position]), begin, begin + size});
+
+        position = begin + size;
+    }
+
+    return messages;
+}
+
+//A forked bench and what it has written so far
+struct child_process {
+    pid_t pid = -1;
+    int fd = -1;        //messages
+    int output_fd = -1; //console output, only captured when several benchs run concurrently
+    int cpu = -1;
+    std::string stream;
+    std::string output;
+    timer_clock::time_point start;
+    bool completed = true; //false if it was killed by the timeout
+    int status = 0;
+
+    bool finished() const {
+        return pid < 0 && fd < 0 && output_fd < 0;
+    }
+};
+
+//Read what is available on the pipe, the pipe is closed at the end of the stream
+inline void read_available(int& fd, std::string& stream){
+    char buffer[4096];
+
+    auto n = ::read(fd, buffer, sizeof(buffer));
+
+    if(n < 0 && (errno == EINTR || errno == EAGAIN)){
+        return;
+    } else if(n <= 0){
+        ::close(fd);
+        fd = -1;
+        return;
+    }
+
+    stream.append(buffer, n);
+}
+
+//Read everything the process writes until it closes the pipe or the timeout expires
+//Returns false if the timeout expired
+inline bool read_until_closed(int fd, std::string& stream, double timeout){
+    auto start = timer_clock::now();
+
+    char buffer[4096];
+
+    while(true){
+        int wait = -1;
+
+        if(timeout > 0.0){
+            auto elapsed = std::chrono::duration_cast<millseconds>(timer_clock::now() - start).count() / 1000.0;
+
+            if(elapsed >= timeout){
+                return false;
+            }
+
+            wait = static_cast<int>((timeout - elapsed) * 1000.0) + 1;
+        }
+
+        pollfd p{fd, POLLIN, 0};
+
+        auto ready = ::poll(&p, 1, wait);
+
+        if(ready < 0 && errno == EINTR){
+            continue;
+        } else if(ready < 0){
+            return true;
+        } else if(ready == 0){
+            continue;
+        }
+
+        auto n = ::read(fd, buffer, sizeof(buffer));
+
+        if(n < 0 && errno == EINTR){
+            continue;
+        } else if(n <= 0){
+            return true;
+        }
+
+        stream.append(buffer, n);
+    }
+}
+
+} //end of namespace cpm
+
+#endif //CPM_ISOLATION_HPP
@@ -8,6 +8,8 @@
 #ifndef CPM_JSON_HPP
 #define CPM_JSON_HPP
 
+#include <vector>
+
 #include <unistd.h>
 #include <sys/stat.h>
 
@@ -31,6 +33,15 @@ inline void write_value(std::ofstream& stream, std::size_t& indent, const std::s
     }
 }
 
+template<>
+inline void write_value(std::ofstream& stream, std::size_t& indent, const std::string& tag, const int& value, bool comma){
+    if(comma){
+        stream << std::string(indent, ' ') << "\"" << tag << "\": " << value << ",\n";
+    } else {
+        stream << std::string(indent, ' ') << "\"" << tag << "\": " << value << "\n";
+    }
+}
+
 template<>
 inline void write_value(std::ofstream& stream, std::size_t& indent, const std::string& tag, const int64_t& value, bool comma){
     if(comma){
@@ -49,6 +60,15 @@ inline void write_value(std::ofstream& stream, std::size_t& indent, const std::s
     }
 }
 
+template<>
+inline void write_value(std::ofstream& stream, std::size_t& indent, const std::string& tag, const bool& value, bool comma){
+    if(comma){
+        stream << std::string(indent, ' ') << "\"" << tag << "\": " << (value ? "true" : "false") << ",\n";
+    } else {
+        stream << std::string(indent, ' ') << "\"" << tag << "\": " << (value ? "true" : "false") << "\n";
+    }
+}
+
 template<>
 inline void write_value(std::ofstream& stream, std::size_t& indent, const std::string& tag, const double& value, bool comma){
     stream << std::fixed;
@@ -60,6 +80,20 @@ inline void write_value(std::ofstream& stream, std::size_t& indent, const std::s
     stream << std::scientific;
 }
 
+//Array of values on a single line
+template<typename T>
+inline void write_array(std::ofstream& stream, std::size_t& indent, const std::string& tag, const std::vector<T>& values, bool comma = true){
+    stream << std::fixed;
+    stream << std::string(indent, ' ') << "\"" << tag << "\": [";
+
+    for(std::size_t i = 0; i < values.size(); ++i){
+        stream << (i ? ", " : "") << values[i];
+    }
+
+    stream << (comma ? "],\n" : "]\n");
+    stream << std::scientific;
+}
+
 inline void start_array(std::ofstream& stream, std::size_t& indent, const std::string& tag){
     stream << std::string(indent, ' ') << "\"" << tag << "\": " << "[" << "\n";
     indent += 2;
@@ -0,0 +1,284 @@
+//=======================================================================
+// Copyright (c) 2015-2016 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef CPM_MONITOR_HPP
+#define CPM_MONITOR_HPP
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <algorithm>
+#include <cstdlib>
+
+#include "duration.hpp"
+#include "placement.hpp"
+#include "config.hpp"
+
+namespace cpm {
+
+//State of the machine at one point of the run
+struct system_sample {
+    double time;        //seconds since the start of the monitor
+    double mhz;         //frequency of the measuring cpu (the fastest cpu if not pinned), 0 if unknown
+    double temperature; //hottest thermal zone in degrees, 0 if unknown
+    double load;        //1 minute load average
+    double steal;       //percent of the time stolen by the hypervisor
+    double iowait;      //percent of the time waiting for IO
+};
+
+//State of the machine during a benchmark
+struct system_summary {
+    std::vector<system_sample> samples; //At most monitor_points samples
+    double mhz_min = 0.0;
+    double mhz_max = 0.0;
+    double temperature_max = 0.0;
+    double load_max = 0.0;
+    double steal_max = 0.0;
+    double iowait_max = 0.0;
+    bool throttled = false; //The frequency dropped below throttle_ratio of the highest frequency of the run
+    bool loaded = false;    //The machine was overloaded, or lost time to steal or iowait
+};
+
+inline double read_double(const std::string& file){
+    std::ifstream stream(file);
+
+    double value = 0.0;
+    if(stream >> value){
+        return value;
+    }
+
+    return -1.0;
+}
+
+inline std::string read_line(const std::string& file){
+    std::ifstream stream(file);
+
+    std::string line;
+    std::getline(stream, line);
+    return line;
+}
+
+//Samples the state of the machine in a background thread
+struct system_monitor {
+    system_monitor() : origin(timer_clock::now()) {}
+
+    system_monitor(const system_monitor&) = delete;
+    system_monitor& operator=(const system_monitor&) = delete;
+
+    ~system_monitor(){
+        stop();
+    }
+
+    //init is called from the sampling thread before the first sample
+    void start(int measure_cpu, std::function<void()> init){
+        if(thread.joinable()){
+            return;
+        }
+
+        cpu = measure_cpu;
+        stopping = false;
+
+        governor = read_line("/sys/devices/system/cpu/cpu" + std::to_string(std::max(0, cpu)) + "/cpufreq/scaling_governor");
+
+        last = read_cpu_times(-1);
+
+        thread = std::thread([this, init](){
+            init();
+
+            std::unique_lock<std::mutex> l(lock);
+
+            while(!stopping){
+                l.unlock();
+                auto s = sample();
+                l.lock();
+
+                samples.push_back(s);
+                peak_mhz = std::max(peak_mhz, s.mhz);
+
+                condition.wait_for(l, std::chrono::duration<double>(cpm::monitor_interval), [this](){ return stopping; });
+            }
+        });
+    }
+
+    void stop(){
+        if(thread.joinable()){
+            {
+                std::lock_guard<std::mutex> l(lock);
+                stopping = true;
+            }
+
+            condition.notify_all();
+            thread.join();
+        }
+    }
+
+    bool running() const {
+        return thread.joinable();
+    }
+
+    bool used() const {
+        return !samples.empty();
+    }
+
+    //Seconds since the start of the monitor
+    double now() const {
+        return std::chrono::duration_cast<nanoseconds>(timer_clock::now() - origin).count() / (1000.0 * 1000.0 * 1000.0);
+    }
+
+    system_summary summary(double start, double end){
+        std::lock_guard<std::mutex> l(lock);
+
+        system_summary summary;
+
+        std::vector<system_sample> window;
+
+        for(auto& s : samples){
+            //The sample taken just before the start still describes the beginning
+            if(s.time <= end && s.time + cpm::monitor_interval >= start){
+                window.push_back(s);
+            }
+        }
+
+        if(window.empty()){
+            return summary;
+        }
+
+        summary.mhz_min = window.front().mhz;
+
+        for(auto& s : window){
+            summary.mhz_min = std::min(summary.mhz_min, s.mhz);
+            summary.mhz_max = std::max(summary.mhz_max, s.mhz);
+            summary.temperature_max = std::max(summary.temperature_max, s.temperature);
+            summary.load_max = std::max(summary.load_max, s.load);
+            summary.steal_max = std::max(summary.steal_max, s.steal);
+            summary.iowait_max = std::max(summary.iowait_max, s.iowait);
+        }
+
+        summary.throttled = peak_mhz > 0.0 && summary.mhz_min < cpm::throttle_ratio * peak_mhz;
+        summary.loaded = summary.load_max > std::max(1U, std::thread::hardware_concurrency())
+            || summary.steal_max > cpm::load_threshold
+            || summary.iowait_max > cpm::load_threshold;
+
+        //Compact the series by averaging consecutive samples
+        std::size_t buckets = std::min(window.size(), cpm::monitor_points);
+
+        for(std::size_t b = 0; b < buckets; ++b){
+            std::size_t first = b * window.size() / buckets;
+            std::size_t last = (b + 1) * window.size() / buckets;
+
+            system_sample average{window[first].time, 0.0, 0.0, 0.0, 0.0, 0.0};
+
+            for(std::size_t i = first; i < last; ++i){
+                average.mhz += window[i].mhz;
+                average.temperature += window[i].temperature;
+                average.load += window[i].load;
+                average.steal += window[i].steal;
+                average.iowait += window[i].iowait;
+            }
+
+            double n = last - first;
+
+            average.mhz /= n;
+            average.temperature /= n;
+            average.load /= n;
+            average.steal /= n;
+            average.iowait /= n;
+
+            summary.samples.push_back(average);
+        }
+
+        return summary;
+    }
+
+    std::string governor;
+
+private:
+    double frequency(){
+        double mhz = 0.0;
+
+        if(cpu >= 0){
+            mhz = read_double("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq/scaling_cur_freq") / 1000.0;
+        } else {
+            for(std::size_t c = 0; c < std::thread::hardware_concurrency(); ++c){
+                mhz = std::max(mhz, read_double("/sys/devices/system/cpu/cpu" + std::to_string(c) + "/cpufreq/scaling_cur_freq") / 1000.0);
+            }
+        }
+
+        if(mhz > 0.0){
+            return mhz;
+        }
+
+        //Without cpufreq (VM for instance), fall back to /proc/cpuinfo
+        mhz = 0.0;
+
+        std::ifstream stream("/proc/cpuinfo");
+        std::string line;
+
+        while(std::getline(stream, line)){
+            if(line.compare(0, 7, "cpu MHz") == 0){
+                auto colon = line.find(':');
+                if(colon != std::string::npos){
+                    mhz = std::max(mhz, std::atof(line.c_str() + colon + 1));
+                }
+            }
+        }
+
+        return mhz;
+    }
+
+    double temperature(){
+        double max = 0.0;
+
+        for(std::size_t zone = 0; ; ++zone){
+            auto value = read_double("/sys/class/thermal/thermal_zone" + std::to_string(zone) + "/temp");
+
+            if(value < 0.0){
+                break;
+            }
+
+            max = std::max(max, value / 1000.0);
+        }
+
+        return max;
+    }
+
+    system_sample sample(){
+        system_sample s{now(), frequency(), temperature(), std::max(0.0, read_double("/proc/loadavg")), 0.0, 0.0};
+
+        auto times = read_cpu_times(-1);
+
+        if(times.total > last.total){
+            double total = times.total - last.total;
+            s.steal = 100.0 * (times.steal - last.steal) / total;
+            s.iowait = 100.0 * (times.iowait - last.iowait) / total;
+        }
+
+        last = times;
+
+        return s;
+    }
+
+    timer_clock::time_point origin;
+    int cpu = -1;
+    cpu_times last;
+
+    std::thread thread;
+    std::mutex lock;
+    std::condition_variable condition;
+    bool stopping = false;
+
+    std::vector<system_sample> samples;
+    double peak_mhz = 0.0;
+};
+
+} //end of namespace cpm
+
+#endif //CPM_MONITOR_HPP
@@ -0,0 +1,129 @@
+//=======================================================================
+// Copyright (c) 2015-2016 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef CPM_PARALLEL_HPP
+#define CPM_PARALLEL_HPP
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <utility>
+#include <initializer_list>
+
+namespace cpm {
+
+//Latency distribution and throughput of one worker thread
+struct thread_result {
+    double mean;
+    double stddev;
+    double min;
+    double max;
+    double throughput; //calls per second
+};
+
+//Results of a parallel measure, the number of threads is zero for sequential measures
+struct parallel_result {
+    std::size_t threads = 0;
+    std::size_t work = 0;    //size of the problem without the threads, 0 if there is none
+    double wall = 0.0;       //mean duration of a sample, from the first start to the last end
+    double throughput = 0.0; //calls per second of all the threads together
+    double fairness = 0.0;   //Jain's index of the per-thread throughputs, 1.0 is perfectly fair
+    std::vector<thread_result> per_thread;
+};
+
+inline thread_result thread_stats(const std::vector<double>& durations){
+    thread_result result{0.0, 0.0, durations[0], durations[0], 0.0};
+
+    double total = 0.0;
+
+    for(auto duration : durations){
+        total += duration;
+        result.min = std::min(result.min, duration);
+        result.max = std::max(result.max, duration);
+    }
+
+    result.mean = total / durations.size();
+
+    for(auto duration : durations){
+        result.stddev += (duration - result.mean) * (duration - result.mean);
+    }
+
+    result.stddev = std::sqrt(result.stddev / durations.size());
+    result.throughput = total == 0.0 ? 0.0 : durations.size() / (total / (1000.0 * 1000.0 * 1000.0));
+
+    return result;
+}
+
+inline double jain_fairness(const std::vector<thread_result>& threads){
+    double sum = 0.0;
+    double sum_sq = 0.0;
+
+    for(auto& thread : threads){
+        sum += thread.throughput;
+        sum_sq += thread.throughput * thread.throughput;
+    }
+
+    return sum_sq == 0.0 ? 0.0 : (sum * sum) / (threads.size() * sum_sq);
+}
+
+//The number of threads of a parallel measure is given by the policy. With
+//several values, the number of threads is the last one and the other values
+//are the size of the problem. All the values are passed to the functor after
+//the thread id, so that the work can be split between the threads
+
+inline std::size_t thread_count(std::size_t d){
+    return std::max(std::size_t(1), d);
+}
+
+template<typename... T>
+std::size_t thread_count(std::tuple<T...> d){
+    return std::max(std::size_t(1), std::size_t(std::get<sizeof...(T) - 1>(d)));
+}
+
+inline std::size_t work_size(std::size_t /*d*/){
+    return 0;
+}
+
+template<typename... T, std::size_t... I>
+std::size_t work_size([[maybe_unused]] std::tuple<T...> d, std::index_sequence<I...> /*s*/){
+    std::size_t work = 1;
+    (void) std::initializer_list<int>{(work *= std::get<I>(d), 0)...};
+    return work;
+}
+
+template<typename... T>
+std::size_t work_size(std::tuple<T...> d){
+    return work_size(d, std::make_index_sequence<sizeof...(T) - 1>());
+}
+
+//Effective size of a parallel measure, the elements processed by all the
+//threads in a sample: the size of the problem, or one call per thread
+template<typename D>
+std::size_t parallel_size(D d){
+    auto work = work_size(d);
+    return work ? work : thread_count(d);
+}
+
+template<typename Functor>
+void call_parallel(Functor& functor, std::size_t thread, std::size_t /*d*/){
+    functor(thread);
+}
+
+template<typename Functor, typename... T, std::size_t... I>
+void call_parallel(Functor& functor, std::size_t thread, std::tuple<T...> d, std::index_sequence<I...> /*s*/){
+    functor(thread, std::get<I>(d)...);
+}
+
+template<typename Functor, typename... T>
+void call_parallel(Functor& functor, std::size_t thread, std::tuple<T...> d){
+    call_parallel(functor, thread, d, std::make_index_sequence<sizeof...(T)>());
+}
+
+} //end of namespace cpm
+
+#endif //CPM_PARALLEL_HPP
@@ -0,0 +1,333 @@
+//=======================================================================
+// Copyright (c) 2015-2016 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef CPM_PEAKS_HPP
+#define CPM_PEAKS_HPP
+
+#include <string>
+#include <vector>
+#include <array>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <thread>
+#include <barrier>
+#include <chrono>
+#include <limits>
+#include <utility>
+#include <cstdlib>
+#include <algorithm>
+
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "compiler.hpp"
+#include "placement.hpp"
+#include "cache.hpp"
+#include "io.hpp"
+#include "config.hpp"
+
+namespace cpm {
+
+//Width of the vectors of the SIMD kernel, the widest enabled at compile time
+#if defined(__AVX512F__)
+static constexpr const std::size_t simd_bytes = 64;
+#elif defined(__AVX__)
+static constexpr const std::size_t simd_bytes = 32;
+#else
+static constexpr const std::size_t simd_bytes = 16;
+#endif
+
+using simd_double = double __attribute__((vector_size(simd_bytes)));
+
+//Best rates of the calibration kernels on one core or on all the cores
+struct peak_values {
+    double copy = 0.0;  //B/s
+    double scale = 0.0; //B/s
+    double add = 0.0;   //B/s
+    double triad = 0.0; //B/s
+    double flops_scalar = 0.0; //Flop/s
+    double flops_simd = 0.0;   //Flop/s
+};
+
+struct machine_peaks {
+    bool valid = false;
+    bool cached = false; //Loaded from the cache file instead of measured
+    std::string cpu;     //Model of the processor
+    std::size_t threads = 0; //Cores of the all-core peaks
+    peak_values single;
+    peak_values all;
+};
+
+//Model name of the processor, empty if unknown
+inline std::string cpu_model(){
+    std::ifstream stream("/proc/cpuinfo");
+    std::string line;
+
+    while(std::getline(stream, line)){
+        if(line.compare(0, 10, "model name") == 0){
+            auto colon = line.find(':');
+            if(colon != std::string::npos && colon + 2 <= line.size()){
+                return line.substr(colon + 2);
+            }
+        }
+    }
+
+    return "";
+}
+
+//The machine, the compiler and the cpus define the peaks
+inline std::string peaks_key(const std::string& cpu, std::size_t threads){
+    char host[256] = {};
+    gethostname(host, sizeof(host) - 1);
+
+    return std::string(host) + "|" + cpu + "|" + COMPILER_FULL + "|" + std::to_string(simd_bytes) + "|" + std::to_string(threads);
+}
+
+//Per-user cache of the calibrations, empty if there is no home
+inline std::string default_peaks_file(){
+    if(auto cache = std::getenv("XDG_CACHE_HOME")){
+        return std::string(cache) + "/cpm/peaks";
+    }
+
+    if(auto home = std::getenv("HOME")){
+        return std::string(home) + "/.cache/cpm/peaks";
+    }
+
+    return "";
+}
+
+//One line per machine: the key, a tab and the twelve peaks
+inline bool load_peaks(const std::string& file, const std::string& key, machine_peaks& peaks){
+    std::ifstream stream(file);
+    std::string line;
+
+    while(std::getline(stream, line)){
+        auto tab = line.find('\t');
+
+        if(tab == std::string::npos || line.compare(0, tab, key) != 0 || tab != key.size()){
+            continue;
+        }
+
+        std::istringstream values(line.substr(tab + 1));
+
+        for(auto* p : {&peaks.single, &peaks.all}){
+            values >> p->copy >> p->scale >> p->add >> p->triad >> p->flops_scalar >> p->flops_simd;
+        }
+
+        if(values){
+            peaks.valid = true;
+            peaks.cached = true;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//The lines of the other machines are kept
+inline bool store_peaks(const std::string& file, const std::string& key, const machine_peaks& peaks){
+    if(file.empty()){
+        return false;
+    }
+
+    //Create the missing folders of the path
+    for(auto slash = file.find('/', 1); slash != std::string::npos; slash = file.find('/', slash + 1)){
+        auto folder = file.substr(0, slash);
+
+        if(!folder_exists(folder)){
+            mkdir(folder.c_str(), 0777);
+        }
+    }
+
+    std::vector<std::string> lines;
+
+    {
+        std::ifstream stream(file);
+        std::string line;
+
+        while(std::getline(stream, line)){
+            if(line.compare(0, key.size() + 1, key + "\t") != 0){
+                lines.push_back(line);
+            }
+        }
+    }
+
+    std::ostringstream line;
+    line << key << "\t" << std::setprecision(std::numeric_limits<double>::max_digits10);
+
+    for(auto* p : {&peaks.single, &peaks.all}){
+        line << p->copy << " " << p->scale << " " << p->add << " " << p->triad << " " << p->flops_scalar << " " << p->flops_simd << " ";
+    }
+
+    lines.push_back(line.str());
+
+    std::ofstream stream(file);
+
+    for(auto& l : lines){
+        stream << l << "\n";
+    }
+
+    return static_cast<bool>(stream);
+}
+
+//Keeps a scalar chain in its own register, the chains must not be vectorized
+template<typename T>
+inline void scalar_barrier([[maybe_unused]] T& value){
+#if defined(__x86_64__) || defined(__i386__)
+    if constexpr (sizeof(T) == sizeof(double)){
+        asm("" : "+x"(value));
+    }
+#endif
+}
+
+//Independent chains of multiply-add, enough of them to hide the latency of
+//the FMA units. The chains are unrolled so that they stay in registers
+template<typename T, std::size_t... I>
+double fma_chains(std::size_t iterations, std::index_sequence<I...>){
+    T acc[] = {(T{} + (1.0 + I * 1e-3))...};
+
+    const T a = T{} + 0.999999;
+    const T b = T{} + 1e-7;
+
+    for(std::size_t i = 0; i < iterations; ++i){
+        ((acc[I] = acc[I] * a + b, scalar_barrier(acc[I])), ...);
+    }
+
+    //The results must not be optimized away
+    [[maybe_unused]] volatile T result = (acc[I] + ...);
+
+    return 2.0 * sizeof...(I) * (sizeof(T) / sizeof(double)) * iterations;
+}
+
+//Returns the number of floating point operations
+template<typename T>
+double fma_kernel(std::size_t iterations){
+    return fma_chains<T>(iterations, std::make_index_sequence<12>());
+}
+
+//Bytes of each array of the STREAM kernels, shared by the threads
+inline std::size_t stream_bytes(int cpu){
+    auto llc = llc_size(std::max(0, cpu));
+    auto bytes = llc ? static_cast<std::size_t>(llc * cpm::peak_stream_factor) : cpm::peak_stream_size;
+    return std::min(bytes, cpm::peak_stream_max);
+}
+
+//Runs the calibration kernels on each of the cpus at the same time (-1 not
+//to pin). Each thread works on its own arrays, touched first by itself so
+//that they are local to its node. The time of a kernel is the time between
+//the barriers around it and the best of the repeats is kept
+inline peak_values measure_peaks(const std::vector<int>& cpus){
+    const std::size_t threads = std::max(std::size_t(1), cpus.size());
+    const std::size_t n = std::max(std::size_t(1024), stream_bytes(cpus.empty() ? 0 : cpus.front()) / sizeof(double) / threads);
+
+    std::barrier<> sync(threads);
+
+    std::array<double, 6> best;
+    std::array<double, 6> work{};
+    best.fill(std::numeric_limits<double>::max());
+
+    auto worker = [&](std::size_t t){
+#ifdef __linux__
+        if(t < cpus.size() && cpus[t] >= 0 && cpus[t] < CPU_SETSIZE){
+            cpu_set_t mask;
+            CPU_ZERO(&mask);
+            CPU_SET(cpus[t], &mask);
+            sched_setaffinity(0, sizeof(mask), &mask);
+        }
+#endif
+
+        std::vector<double> a(n, 1.0);
+        std::vector<double> b(n, 2.0);
+        std::vector<double> c(n, 0.0);
+
+        const double s = 3.0;
+
+        auto run = [&](std::size_t k, auto kernel){
+            for(std::size_t r = 0; r < cpm::peak_repeats; ++r){
+                sync.arrive_and_wait();
+
+                auto start = std::chrono::steady_clock::now();
+                auto amount = kernel();
+
+                sync.arrive_and_wait();
+
+                if(t == 0){
+                    best[k] = std::min(best[k], std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+                    work[k] = amount;
+                }
+            }
+        };
+
+        auto sink = [](double* data){
+            asm volatile("" : : "r"(data) : "memory");
+        };
+
+        //The bytes are counted as in STREAM, without the write allocations
+        run(0, [&]{ for(std::size_t i = 0; i < n; ++i){ c[i] = a[i]; } sink(c.data()); return 16.0 * n; });
+        run(1, [&]{ for(std::size_t i = 0; i < n; ++i){ b[i] = s * c[i]; } sink(b.data()); return 16.0 * n; });
+        run(2, [&]{ for(std::size_t i = 0; i < n; ++i){ c[i] = a[i] + b[i]; } sink(c.data()); return 24.0 * n; });
+        run(3, [&]{ for(std::size_t i = 0; i < n; ++i){ a[i] = b[i] + s * c[i]; } sink(a.data()); return 24.0 * n; });
+
+        run(4, [&]{ return fma_kernel<double>(cpm::peak_fma_iterations); });
+        run(5, [&]{ return fma_kernel<simd_double>(cpm::peak_fma_iterations); });
+    };
+
+    std::vector<std::thread> workers;
+    for(std::size_t t = 1; t < threads; ++t){
+        workers.emplace_back(worker, t);
+    }
+
+    //The calling thread keeps its own affinity, it runs the kernels in a thread too
+    std::thread first(worker, 0);
+    first.join();
+
+    for(auto& w : workers){
+        w.join();
+    }
+
+    std::array<double, 6> rates;
+    for(std::size_t k = 0; k < rates.size(); ++k){
+        rates[k] = threads * work[k] / best[k];
+    }
+
+    return {rates[0], rates[1], rates[2], rates[3], rates[4], rates[5]};
+}
+
+//Peaks of the machine, from the cache file if this machine has already been
+//calibrated. cpu is the core of the single-core peaks (-1 for the first
+//allowed one), the all-core peaks use every allowed cpu
+inline machine_peaks calibrate_peaks(int cpu, const std::string& file, bool recalibrate){
+    machine_peaks peaks;
+
+    auto cpus = allowed_cpus();
+
+    peaks.cpu = cpu_model();
+    peaks.threads = std::max(std::size_t(1), cpus.size());
+
+    auto key = peaks_key(peaks.cpu, peaks.threads);
+
+    if(!recalibrate && !file.empty() && load_peaks(file, key, peaks)){
+        return peaks;
+    }
+
+    if(cpu < 0){
+        cpu = cpus.empty() ? -1 : cpus.front();
+    }
+
+    peaks.single = measure_peaks({cpu});
+    peaks.all = cpus.size() > 1 ? measure_peaks(cpus) : peaks.single;
+    peaks.valid = true;
+
+    store_peaks(file, key, peaks);
+
+    return peaks;
+}
+
+} //end of namespace cpm
+
+#endif //CPM_PEAKS_HPP
@@ -0,0 +1,395 @@
+//=======================================================================
+// Copyright (c) 2015-2016 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef CPM_PLACEMENT_HPP
+#define CPM_PLACEMENT_HPP
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#endif
+
+namespace cpm {
+
+//Parse a cpu list of the kernel ("0-3,8,10-11")
+inline std::vector<int> parse_cpu_list(const std::string& list){
+    std::vector<int> cpus;
+
+    std::stringstream ss(list);
+    std::string range;
+
+    while(std::getline(ss, range, ',')){
+        auto dash = range.find('-');
+
+        try {
+            if(dash == std::string::npos){
+                cpus.push_back(std::stoi(range));
+            } else {
+                auto first = std::stoi(range.substr(0, dash));
+                auto last = std::stoi(range.substr(dash + 1));
+
+                for(int cpu = first; cpu <= last; ++cpu){
+                    cpus.push_back(cpu);
+                }
+            }
+        } catch (const std::exception&){
+            //Ignore invalid ranges
+        }
+    }
+
+    return cpus;
+}
+
+//Other hardware threads of the same core
+inline std::vector<int> smt_siblings(int cpu){
+    std::ifstream stream("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/thread_siblings_list");
+
+    std::string list;
+    std::getline(stream, list);
+
+    std::vector<int> siblings;
+
+    for(auto sibling : parse_cpu_list(list)){
+        if(sibling != cpu){
+            siblings.push_back(sibling);
+        }
+    }
+
+    return siblings;
+}
+
+//Cpus of the last level cache shared by the cpu
+inline std::string cache_domain(int cpu){
+    std::string domain;
+
+    for(std::size_t index = 0; ; ++index){
+        std::ifstream stream("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cache/index" + std::to_string(index) + "/shared_cpu_list");
+
+        if(!stream){
+            break;
+        }
+
+        std::getline(stream, domain);
+    }
+
+    return domain;
+}
+
+//Cpus the process is allowed to run on
+inline std::vector<int> allowed_cpus(){
+    std::vector<int> cpus;
+
+#ifdef __linux__
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+
+    if(!sched_getaffinity(0, sizeof(mask), &mask)){
+        for(int cpu = 0; cpu < CPU_SETSIZE; ++cpu){
+            if(CPU_ISSET(cpu, &mask)){
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#endif
+
+    return cpus;
+}
+
+//At most n cpus on distinct cores, spread over the cache domains first so
+//that the benchs running concurrently share as little as possible
+inline std::vector<int> spread_cpus(std::size_t n){
+    auto allowed = allowed_cpus();
+
+    std::vector<std::string> domains;
+    std::vector<std::vector<int>> cores;
+
+    for(auto cpu : allowed){
+        bool taken = false;
+
+        for(auto sibling : smt_siblings(cpu)){
+            for(auto& domain : cores){
+                taken = taken || std::find(domain.begin(), domain.end(), sibling) != domain.end();
+            }
+        }
+
+        if(taken){
+            continue;
+        }
+
+        auto domain = cache_domain(cpu);
+        auto it = std::find(domains.begin(), domains.end(), domain);
+
+        if(it == domains.end()){
+            domains.push_back(domain);
+            cores.emplace_back();
+            cores.back().push_back(cpu);
+        } else {
+            cores[it - domains.begin()].push_back(cpu);
+        }
+    }
+
+    std::vector<int> cpus;
+
+    for(std::size_t i = 0; cpus.size() < n; ++i){
+        bool any = false;
+
+        for(auto& domain : cores){
+            if(i < domain.size() && cpus.size() < n){
+                cpus.push_back(domain[i]);
+                any = true;
+            }
+        }
+
+        if(!any){
+            break;
+        }
+    }
+
+    return cpus;
+}
+
+//Cumulative jiffies of a cpu from /proc/stat
+struct cpu_times {
+    unsigned long long busy = 0;
+    unsigned long long iowait = 0;
+    unsigned long long steal = 0;
+    unsigned long long total = 0;
+};
+
+//Times of one cpu or of all the cpus together if cpu is negative
+inline cpu_times read_cpu_times(int cpu){
+    std::ifstream stream("/proc/stat");
+
+    std::string label = cpu < 0 ? std::string("cpu") : "cpu" + std::to_string(cpu);
+    std::string line;
+
+    cpu_times times;
+
+    while(std::getline(stream, line)){
+        std::stringstream ss(line);
+
+        std::string name;
+        ss >> name;
+
+        if(name == label){
+            //user nice system idle iowait irq softirq steal
+            unsigned long long values[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+
+            for(auto& value : values){
+                ss >> value;
+                times.total += value;
+            }
+
+            times.busy = times.total - values[3] - values[4];
+            times.iowait = values[4];
+            times.steal = values[7];
+
+            break;
+        }
+    }
+
+    return times;
+}
+
+//Placement of the measuring thread on the machine and how it is scheduled
+//Each setting is only applied when permitted, the others are reported as warnings
+struct cpu_placement {
+    //Requested placement
+    int cpu = -1;               //Core of the measuring thread, -1 to let the scheduler decide
+    bool idle_siblings = false; //Keep the SMT siblings of the core free of our own threads and check that they are idle
+    bool realtime = false;      //SCHED_FIFO for the measuring thread
+    int nice = 0;
+    bool lock_memory = false;   //mlockall
+
+    //Applied placement
+    bool pinned = false;
+    std::vector<int> siblings;
+    double sibling_load = 0.0; //Highest busy fraction of the siblings
+    bool fifo = false;
+    int applied_nice = 0;
+    bool locked = false;
+    std::vector<std::string> warnings;
+
+    bool requested() const {
+        return cpu >= 0 || realtime || nice != 0 || lock_memory;
+    }
+
+    void apply(){
+#ifdef __linux__
+        CPU_ZERO(&workers_mask);
+        sched_getaffinity(0, sizeof(workers_mask), &workers_mask);
+
+        if(cpu >= CPU_SETSIZE){
+            warnings.push_back("Impossible to pin to cpu " + std::to_string(cpu) + ": invalid cpu");
+        } else if(cpu >= 0){
+            cpu_set_t mask;
+            CPU_ZERO(&mask);
+            CPU_SET(cpu, &mask);
+
+            //Only the calling thread is pinned, the worker threads are placed by release_worker()
+            if(sched_setaffinity(0, sizeof(mask), &mask)){
+                warnings.push_back("Impossible to pin to cpu " + std::to_string(cpu) + ": " + std::strerror(errno));
+            } else {
+                pinned = true;
+                siblings = smt_siblings(cpu);
+            }
+        }
+
+        if(pinned && idle_siblings){
+            for(auto sibling : siblings){
+                CPU_CLR(sibling, &workers_mask);
+            }
+
+            if(!CPU_COUNT(&workers_mask)){
+                sched_getaffinity(0, sizeof(workers_mask), &workers_mask);
+            }
+
+            //The siblings cannot be reserved without isolcpus, only check that they are idle
+            std::vector<cpu_times> before;
+            for(auto sibling : siblings){
+                before.push_back(read_cpu_times(sibling));
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+            for(std::size_t i = 0; i < siblings.size(); ++i){
+                auto after = read_cpu_times(siblings[i]);
+
+                if(after.total > before[i].total){
+                    sibling_load = std::max(sibling_load, double(after.busy - before[i].busy) / (after.total - before[i].total));
+                }
+            }
+
+            if(sibling_load > 0.1){
+                warnings.push_back("The SMT sibling of cpu " + std::to_string(cpu) + " is busy (" + std::to_string(int(sibling_load * 100.0)) + "%)");
+            }
+        }
+
+        if(realtime){
+            sched_param param;
+            param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+
+            if(sched_setscheduler(0, SCHED_FIFO, &param)){
+                warnings.push_back(std::string("Impossible to use SCHED_FIFO: ") + std::strerror(errno));
+            } else {
+                fifo = true;
+            }
+        }
+
+        if(nice != 0){
+            if(setpriority(PRIO_PROCESS, 0, nice)){
+                warnings.push_back("Impossible to set nice " + std::to_string(nice) + ": " + std::strerror(errno));
+            } else {
+                applied_nice = nice;
+            }
+        }
+
+        if(lock_memory){
+            if(mlockall(MCL_CURRENT | MCL_FUTURE)){
+                warnings.push_back(std::string("Impossible to lock the memory: ") + std::strerror(errno));
+            } else {
+                locked = true;
+            }
+        }
+#else
+        if(requested()){
+            warnings.push_back("Placement is only supported on Linux");
+        }
+#endif
+    }
+
+    //Called by the worker threads of the parallel measures so that they
+    //are not all pinned on the core of the measuring thread
+    void release_worker() const {
+#ifdef __linux__
+        if(pinned){
+            sched_setaffinity(0, sizeof(workers_mask), &workers_mask);
+        }
+
+        release_scheduler();
+#endif
+    }
+
+    std::string siblings_str() const {
+        std::string result;
+
+        for(auto sibling : siblings){
+            result += (result.empty() ? "" : ",") + std::to_string(sibling);
+        }
+
+        return result;
+    }
+
+    //Move the calling thread away from the measuring core
+    void move_away() const {
+#ifdef __linux__
+        if(pinned){
+            cpu_set_t mask = workers_mask;
+            CPU_CLR(cpu, &mask);
+
+            if(CPU_COUNT(&mask)){
+                sched_setaffinity(0, sizeof(mask), &mask);
+            }
+        }
+
+        release_scheduler();
+#endif
+    }
+
+    //Summary of the applied placement, used to compare runs
+    std::string str() const {
+        std::string result = pinned ? "cpu " + std::to_string(cpu) : std::string("unpinned");
+
+        if(pinned && idle_siblings && !siblings.empty()){
+            result += " (SMT siblings " + siblings_str() + " excluded)";
+        }
+
+        if(fifo){
+            result += ", SCHED_FIFO";
+        }
+
+        if(applied_nice){
+            result += ", nice " + std::to_string(applied_nice);
+        }
+
+        if(locked){
+            result += ", mlockall";
+        }
+
+        return result;
+    }
+
+private:
+#ifdef __linux__
+    //The threads created after apply() inherit SCHED_FIFO, only the
+    //measuring thread keeps it
+    void release_scheduler() const {
+        if(fifo){
+            sched_param param;
+            param.sched_priority = 0;
+            sched_setscheduler(0, SCHED_OTHER, &param);
+        }
+    }
+
+    cpu_set_t workers_mask;
+#endif
+};
+
+} //end of namespace cpm
+
+#endif //CPM_PLACEMENT_HPP
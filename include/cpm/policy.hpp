@@ -9,12 +9,18 @@
 #define CPM_POLICY_HPP
 
 #include <array>
+#include <algorithm>
+#include <thread>
+#include <type_traits>
 
 #include "duration.hpp"
 #include "compat.hpp"
 
 namespace cpm {
 
+template<std::size_t S>
+struct constant_policy;
+
 namespace detail {
 
 template<typename H>
@@ -32,13 +38,26 @@ struct nth_type {
     using type = typename std::tuple_element<N, std::tuple<T...>>::type;
 };
 
+template<typename Policy>
+struct is_constant_policy : std::false_type {};
+
+template<std::size_t S>
+struct is_constant_policy<constant_policy<S>> : std::true_type {};
+
+//A constant policy never stops the other policies of a nary_policy
+template<typename Policy, typename D>
+constexpr bool nary_has_next(std::size_t i, D d, measure_result duration){
+    return is_constant_policy<Policy>::value || Policy::has_next(i, d, duration);
+}
+
 template<typename Tuple, typename Sequence, typename... Policy>
 struct has_next;
 
 template<typename Tuple, std::size_t... I, typename... Policy>
 struct has_next<Tuple, std::index_sequence<I...>, Policy...> {
     static constexpr bool value(std::size_t i, Tuple d, measure_result duration){
-        return all_and((nth_type<I, Policy...>::type::has_next(i, std::get<I>(d), duration))...);
+        return !all_and(is_constant_policy<Policy>::value...)
+            && all_and((nary_has_next<typename nth_type<I, Policy...>::type>(i, std::get<I>(d), duration))...);
     }
 };
 
@@ -126,6 +145,79 @@ struct values_policy {
     }
 };
 
+//Always the same size, combined with threads_policy for strong scaling. It
+//does not stop the other policies of a nary_policy, on its own it only
+//gives one measure
+template<std::size_t S>
+struct constant_policy {
+    static constexpr std::size_t begin(){
+        return S;
+    }
+
+    static constexpr bool has_next(std::size_t /*i*/, std::size_t /*d*/, measure_result /*duration*/){
+        return false;
+    }
+
+    static constexpr std::size_t next(std::size_t /*i*/, std::size_t /*d*/){
+        return S;
+    }
+};
+
+//Number of threads: powers of two up to M threads (or the number of hardware
+//threads if M is 0). The maximum is always the last value, even if it is not
+//a power of two. In a nary_policy, the number of threads must be the last value
+template<std::size_t M = 0>
+struct threads_policy {
+    static std::size_t max_threads(){
+        return M ? M : std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    static constexpr std::size_t begin(){
+        return 1;
+    }
+
+    static bool has_next(std::size_t /*i*/, std::size_t d, measure_result /*duration*/){
+        return d < max_threads();
+    }
+
+    static std::size_t next(std::size_t /*i*/, std::size_t d){
+        return std::min(d * 2, max_threads());
+    }
+};
+
+//Size fixed at S, with more and more threads
+template<std::size_t S, std::size_t M = 0>
+struct strong_scaling_policy {
+    static cpp14_constexpr std::tuple<std::size_t, std::size_t> begin(){
+        return std::make_tuple(S, threads_policy<M>::begin());
+    }
+
+    static bool has_next(std::size_t i, std::tuple<std::size_t, std::size_t> d, measure_result duration){
+        return threads_policy<M>::has_next(i, std::get<1>(d), duration);
+    }
+
+    static std::tuple<std::size_t, std::size_t> next(std::size_t i, std::tuple<std::size_t, std::size_t> d){
+        return std::make_tuple(S, threads_policy<M>::next(i, std::get<1>(d)));
+    }
+};
+
+//Size of S per thread, growing with the number of threads
+template<std::size_t S, std::size_t M = 0>
+struct weak_scaling_policy {
+    static cpp14_constexpr std::tuple<std::size_t, std::size_t> begin(){
+        return std::make_tuple(S * threads_policy<M>::begin(), threads_policy<M>::begin());
+    }
+
+    static bool has_next(std::size_t i, std::tuple<std::size_t, std::size_t> d, measure_result duration){
+        return threads_policy<M>::has_next(i, std::get<1>(d), duration);
+    }
+
+    static std::tuple<std::size_t, std::size_t> next(std::size_t i, std::tuple<std::size_t, std::size_t> d){
+        auto threads = threads_policy<M>::next(i, std::get<1>(d));
+        return std::make_tuple(S * threads, threads);
+    }
+};
+
 template<nary_combination_policy NCB, typename... Policy>
 struct nary_policy {
     template<typename T = int> //Simply to fake debug symbols for auto
@@ -146,6 +238,7 @@ struct nary_policy {
 
 using std_stop_policy = increasing_policy<10, 1000000, 0, 10, stop_policy::STOP>;
 using std_timeout_policy = increasing_policy<10, 1000, 0, 10, stop_policy::TIMEOUT>;
+using std_threads_policy = threads_policy<>;
 
 template<typename... Policy>
 using simple_nary_policy = nary_policy<nary_combination_policy::PARALLEL, Policy...>;
@@ -0,0 +1,98 @@
+//=======================================================================
+// Copyright (c) 2015-2016 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef CPM_RESOURCES_HPP
+#define CPM_RESOURCES_HPP
+
+#include <string>
+#include <fstream>
+
+#include <sys/time.h>
+#include <sys/resource.h>
+
+namespace cpm {
+
+//Usage of the resources of the process (or of the calling thread) at one point
+struct resource_usage {
+    long minor_faults = 0;
+    long major_faults = 0;
+    long voluntary_switches = 0;
+    long involuntary_switches = 0;
+    long peak_rss = 0; //bytes, high water mark of the process
+};
+
+//Resources used by the sampling of a measure
+struct resource_result {
+    bool measured = false;
+    double rss_growth = 0.0; //bytes added to the peak RSS of the process
+    double minor_faults = 0.0;
+    double major_faults = 0.0;
+    double voluntary_switches = 0.0;
+    double involuntary_switches = 0.0;
+};
+
+//The peak RSS of /proc is more precise than the one of getrusage, which is
+//only updated when the memory is unmapped
+inline long read_peak_rss(){
+    std::ifstream stream("/proc/self/status");
+
+    std::string line;
+    while(std::getline(stream, line)){
+        if(line.compare(0, 6, "VmHWM:") == 0){
+            return std::stol(line.substr(6)) * 1024;
+        }
+    }
+
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) == 0){
+        return usage.ru_maxrss * 1024;
+    }
+
+    return 0;
+}
+
+//The faults and the context switches of the calling thread only, or of the whole process
+inline resource_usage read_resource_usage(bool thread){
+    resource_usage result;
+
+    struct rusage usage;
+
+#ifdef RUSAGE_THREAD
+    int who = thread ? RUSAGE_THREAD : RUSAGE_SELF;
+#else
+    (void) thread;
+    int who = RUSAGE_SELF;
+#endif
+
+    if(getrusage(who, &usage) == 0){
+        result.minor_faults = usage.ru_minflt;
+        result.major_faults = usage.ru_majflt;
+        result.voluntary_switches = usage.ru_nvcsw;
+        result.involuntary_switches = usage.ru_nivcsw;
+    }
+
+    result.peak_rss = read_peak_rss();
+
+    return result;
+}
+
+inline resource_result resource_difference(const resource_usage& before, const resource_usage& after){
+    resource_result result;
+
+    result.measured = true;
+    result.rss_growth = after.peak_rss - before.peak_rss;
+    result.minor_faults = after.minor_faults - before.minor_faults;
+    result.major_faults = after.major_faults - before.major_faults;
+    result.voluntary_switches = after.voluntary_switches - before.voluntary_switches;
+    result.involuntary_switches = after.involuntary_switches - before.involuntary_switches;
+
+    return result;
+}
+
+} //end of namespace cpm
+
+#endif //CPM_RESOURCES_HPP
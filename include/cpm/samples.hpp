@@ -0,0 +1,286 @@
+//=======================================================================
+// Copyright (c) 2015-2016 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef CPM_SAMPLES_HPP
+#define CPM_SAMPLES_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+#include <bit>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace cpm {
+
+//Raw samples of a run, written next to N.cpm as N.samples. The file is
+//little-endian and only made of fixed-size records, so that it can be used
+//directly once mapped in memory:
+//
+//  header                          32 bytes
+//  series entries                  64 bytes each
+//  samples of each series          24 bytes each, 8-byte aligned
+//  names of the series             not terminated
+
+static constexpr const char sample_magic[8] = {'C', 'P', 'M', 'R', 'A', 'W', '\0', '\0'};
+static constexpr const uint32_t sample_version = 1;
+
+struct sample_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t series;
+    uint64_t index_offset;
+};
+
+//A series is identified by its group (bench title or section name), its
+//implementation (empty for a bench) and its size
+struct sample_entry {
+    uint64_t group_offset;
+    uint64_t group_size;
+    uint64_t name_offset;
+    uint64_t name_size;
+    uint64_t size_offset;
+    uint64_t size_size;
+    uint64_t samples_offset;
+    uint64_t samples_count;
+};
+
+struct sample_record {
+    uint64_t index;  //position of the sample in the measure
+    double time;     //end of the sample, in seconds since the start of the run
+    double duration; //ns per call
+};
+
+static_assert(sizeof(sample_header) == 32, "The layout of the samples file is fixed");
+static_assert(sizeof(sample_entry) == 64, "The layout of the samples file is fixed");
+static_assert(sizeof(sample_record) == 24, "The layout of the samples file is fixed");
+
+//Samples of one series to write
+struct sample_series {
+    std::string group;
+    std::string name;
+    std::string size;
+    const std::vector<double>* durations;
+    const std::vector<double>* times;
+};
+
+inline bool write_samples(const std::string& file, const std::vector<sample_series>& series){
+    //The records are written as they are in memory
+    if(std::endian::native != std::endian::little){
+        return false;
+    }
+
+    std::vector<sample_entry> entries;
+    std::string names;
+
+    uint64_t offset = sizeof(sample_header) + series.size() * sizeof(sample_entry);
+
+    for(auto& s : series){
+        sample_entry entry;
+        entry.samples_offset = offset;
+        entry.samples_count = s.durations->size();
+
+        offset += entry.samples_count * sizeof(sample_record);
+
+        entries.push_back(entry);
+    }
+
+    for(std::size_t i = 0; i < series.size(); ++i){
+        entries[i].group_offset = offset + names.size();
+        entries[i].group_size = series[i].group.size();
+        names += series[i].group;
+
+        entries[i].name_offset = offset + names.size();
+        entries[i].name_size = series[i].name.size();
+        names += series[i].name;
+
+        entries[i].size_offset = offset + names.size();
+        entries[i].size_size = series[i].size.size();
+        names += series[i].size;
+    }
+
+    std::ofstream stream(file, std::ios::binary);
+
+    if(!stream){
+        return false;
+    }
+
+    sample_header header;
+    std::memcpy(header.magic, sample_magic, sizeof(header.magic));
+    header.version = sample_version;
+    header.reserved = 0;
+    header.series = series.size();
+    header.index_offset = sizeof(sample_header);
+
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    stream.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(sample_entry));
+
+    for(auto& s : series){
+        std::vector<sample_record> records(s.durations->size());
+
+        for(std::size_t i = 0; i < records.size(); ++i){
+            //Parallel measures do not have the time of each sample
+            records[i] = {i, i < s.times->size() ? (*s.times)[i] : 0.0, (*s.durations)[i]};
+        }
+
+        stream.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(sample_record));
+    }
+
+    stream.write(names.data(), names.size());
+
+    return static_cast<bool>(stream);
+}
+
+//Read-only mapping of a samples file, nothing is parsed
+struct sample_file {
+    sample_file() = default;
+
+    sample_file(const sample_file&) = delete;
+    sample_file& operator=(const sample_file&) = delete;
+
+    ~sample_file(){
+        close();
+    }
+
+    bool open(const std::string& file){
+        close();
+
+        if(std::endian::native != std::endian::little){
+            return false;
+        }
+
+        int fd = ::open(file.c_str(), O_RDONLY);
+
+        if(fd < 0){
+            return false;
+        }
+
+        struct stat buffer;
+        if(fstat(fd, &buffer) || std::size_t(buffer.st_size) < sizeof(sample_header)){
+            ::close(fd);
+            return false;
+        }
+
+        length = buffer.st_size;
+        auto address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+
+        if(address == MAP_FAILED){
+            return false;
+        }
+
+        data = static_cast<const char*>(address);
+
+        if(!valid()){
+            close();
+            return false;
+        }
+
+        return true;
+    }
+
+    void close(){
+        if(data){
+            munmap(const_cast<char*>(data), length);
+            data = nullptr;
+            length = 0;
+        }
+    }
+
+    bool is_open() const {
+        return data;
+    }
+
+    std::size_t series() const {
+        return header().series;
+    }
+
+    std::string_view group(std::size_t i) const {
+        return {data + entry(i).group_offset, entry(i).group_size};
+    }
+
+    std::string_view name(std::size_t i) const {
+        return {data + entry(i).name_offset, entry(i).name_size};
+    }
+
+    std::string_view size(std::size_t i) const {
+        return {data + entry(i).size_offset, entry(i).size_size};
+    }
+
+    std::size_t count(std::size_t i) const {
+        return entry(i).samples_count;
+    }
+
+    const sample_record* samples(std::size_t i) const {
+        return reinterpret_cast<const sample_record*>(data + entry(i).samples_offset);
+    }
+
+    //Index of the series, series() if there is none
+    std::size_t find(std::string_view g, std::string_view n, std::string_view s) const {
+        for(std::size_t i = 0; i < series(); ++i){
+            if(group(i) == g && name(i) == n && size(i) == s){
+                return i;
+            }
+        }
+
+        return series();
+    }
+
+private:
+    const sample_header& header() const {
+        return *reinterpret_cast<const sample_header*>(data);
+    }
+
+    const sample_entry& entry(std::size_t i) const {
+        return reinterpret_cast<const sample_entry*>(data + header().index_offset)[i];
+    }
+
+    //Check the bounds once so that the accessors do not have to
+    bool valid() const {
+        auto& h = header();
+
+        if(std::memcmp(h.magic, sample_magic, sizeof(h.magic)) || h.version != sample_version){
+            return false;
+        }
+
+        if(h.index_offset % 8 || h.index_offset > length || h.series > (length - h.index_offset) / sizeof(sample_entry)){
+            return false;
+        }
+
+        for(std::size_t i = 0; i < h.series; ++i){
+            auto& e = entry(i);
+
+            auto in = [this](uint64_t offset, uint64_t size){
+                return offset <= length && size <= length - offset;
+            };
+
+            if(e.samples_offset % 8 || e.samples_count > length / sizeof(sample_record) || !in(e.samples_offset, e.samples_count * sizeof(sample_record))){
+                return false;
+            }
+
+            if(!in(e.group_offset, e.group_size) || !in(e.name_offset, e.name_size) || !in(e.size_offset, e.size_size)){
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    const char* data = nullptr;
+    std::size_t length = 0;
+};
+
+} //end of namespace cpm
+
+#endif //CPM_SAMPLES_HPP
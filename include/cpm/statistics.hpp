@@ -0,0 +1,589 @@
+//=======================================================================
+// Copyright (c) 2015-2016 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#ifndef CPM_STATISTICS_HPP
+#define CPM_STATISTICS_HPP
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+#include <limits>
+#include <utility>
+
+namespace cpm {
+
+//Order statistics of the samples, they are not moved by a few preempted samples
+struct robust_result {
+    double median = 0.0;
+    double median_lb = 0.0; //95% confidence interval of the median
+    double median_ub = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+    double p999 = 0.0;
+    double q1 = 0.0;
+    double q3 = 0.0;
+    double mad = 0.0; //median absolute deviation, not scaled
+    double iqr = 0.0; //q3 - q1
+    std::size_t mild_outliers = 0;   //between 1.5 and 3 IQR outside of the quartiles
+    std::size_t severe_outliers = 0; //more than 3 IQR outside of the quartiles
+};
+
+//Percentile of sorted values, interpolated between the closest ranks
+inline double percentile(const std::vector<double>& sorted, double p){
+    if(sorted.empty()){
+        return 0.0;
+    }
+
+    double rank = p * (sorted.size() - 1);
+    auto low = static_cast<std::size_t>(std::floor(rank));
+    auto high = std::min(low + 1, sorted.size() - 1);
+
+    return sorted[low] + (rank - low) * (sorted[high] - sorted[low]);
+}
+
+inline robust_result robust_stats(std::vector<double> durations){
+    robust_result result;
+
+    if(durations.empty()){
+        return result;
+    }
+
+    std::sort(durations.begin(), durations.end());
+
+    result.median = percentile(durations, 0.5);
+    result.p90 = percentile(durations, 0.9);
+    result.p99 = percentile(durations, 0.99);
+    result.p999 = percentile(durations, 0.999);
+    result.q1 = percentile(durations, 0.25);
+    result.q3 = percentile(durations, 0.75);
+    result.iqr = result.q3 - result.q1;
+
+    //Tukey's fences
+    for(auto duration : durations){
+        if(duration < result.q1 - 3.0 * result.iqr || duration > result.q3 + 3.0 * result.iqr){
+            ++result.severe_outliers;
+        } else if(duration < result.q1 - 1.5 * result.iqr || duration > result.q3 + 1.5 * result.iqr){
+            ++result.mild_outliers;
+        }
+    }
+
+    //Distribution-free interval from the ranks, replaced by the bootstrap if enabled
+    auto n = durations.size();
+    auto spread = 1.96 * std::sqrt(double(n)) / 2.0;
+    auto lower = static_cast<std::size_t>(std::max(0.0, std::floor(n / 2.0 - spread)));
+    auto upper = static_cast<std::size_t>(std::min(double(n - 1), std::ceil(n / 2.0 + spread)));
+
+    result.median_lb = durations[lower];
+    result.median_ub = durations[upper];
+
+    for(auto& duration : durations){
+        duration = std::abs(duration - result.median);
+    }
+
+    std::sort(durations.begin(), durations.end());
+
+    result.mad = percentile(durations, 0.5);
+
+    return result;
+}
+
+//Half-width of the 95% confidence interval of the mean relative to the mean,
+//with the normal approximation (the interval reported without bootstrap)
+inline double relative_half_width(const std::vector<double>& durations){
+    if(durations.size() < 2){
+        return std::numeric_limits<double>::max();
+    }
+
+    double mean = 0.0;
+
+    for(auto duration : durations){
+        mean += duration;
+    }
+
+    mean /= durations.size();
+
+    double stddev = 0.0;
+
+    for(auto duration : durations){
+        stddev += (duration - mean) * (duration - mean);
+    }
+
+    stddev = std::sqrt(stddev / durations.size());
+
+    return mean == 0.0 ? 0.0 : 1.96 * stddev / std::sqrt(double(durations.size())) / mean;
+}
+
+//95% confidence intervals of the mean and of the median
+struct confidence_result {
+    double mean_lb;
+    double mean_ub;
+    double median_lb;
+    double median_ub;
+};
+
+inline uint64_t splitmix64(uint64_t& state){
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+//Percentile bootstrap. Each resample has its own random stream derived from
+//the seed, so the result does not depend on the number of threads. The
+//resamples are split between threads for large runs, init is called at the
+//start of each thread
+template<typename Init>
+confidence_result bootstrap(std::vector<double> durations, std::size_t resamples, uint64_t seed, Init init){
+    if(durations.empty() || !resamples){
+        return {0.0, 0.0, 0.0, 0.0};
+    }
+
+    std::sort(durations.begin(), durations.end());
+
+    const std::size_t n = durations.size();
+
+    std::vector<double> means(resamples);
+    std::vector<double> medians(resamples);
+
+    auto work = [&](std::size_t first, std::size_t last){
+        //The resamples are drawn as indices in the sorted samples, so that
+        //the median is found by counting the draws of each index
+        std::vector<uint32_t> counts(n);
+
+        for(std::size_t r = first; r < last; ++r){
+            uint64_t state = seed + r * 0xD1B54A32D192ED03ULL;
+
+            std::fill(counts.begin(), counts.end(), 0);
+
+            double sum = 0.0;
+
+            for(std::size_t i = 0; i < n; ++i){
+                auto index = ((splitmix64(state) >> 32) * n) >> 32;
+                sum += durations[index];
+                ++counts[index];
+            }
+
+            means[r] = sum / n;
+
+            //Values of rank (n - 1) / 2 and n / 2 of the resample
+            std::size_t seen = 0;
+            std::size_t index = 0;
+
+            while(seen + counts[index] <= (n - 1) / 2){
+                seen += counts[index++];
+            }
+
+            auto lower = durations[index];
+
+            while(seen + counts[index] <= n / 2){
+                seen += counts[index++];
+            }
+
+            medians[r] = (lower + durations[index]) / 2.0;
+        }
+    };
+
+    std::size_t threads = 1;
+
+    //Threads are only worth it for large runs
+    if(n * resamples > (1UL << 22)){
+        threads = std::max(1U, std::thread::hardware_concurrency());
+        threads = std::min(threads, resamples);
+    }
+
+    if(threads == 1){
+        work(0, resamples);
+    } else {
+        std::vector<std::thread> workers;
+
+        for(std::size_t t = 0; t < threads; ++t){
+            workers.emplace_back([&, t](){
+                init();
+                work(t * resamples / threads, (t + 1) * resamples / threads);
+            });
+        }
+
+        for(auto& worker : workers){
+            worker.join();
+        }
+    }
+
+    std::sort(means.begin(), means.end());
+    std::sort(medians.begin(), medians.end());
+
+    return {percentile(means, 0.025), percentile(means, 0.975), percentile(medians, 0.025), percentile(medians, 0.975)};
+}
+
+//Significance of the difference between two sets of samples
+struct significance_result {
+    double p_value; //two-sided
+    double effect;  //size of the difference, positive when the second set is slower
+};
+
+//Continued fraction of the incomplete beta function (modified Lentz)
+inline double incomplete_beta_fraction(double a, double b, double x){
+    const double tiny = 1e-300;
+
+    auto clamp = [tiny](double v){ return std::abs(v) < tiny ? tiny : v; };
+
+    double c = 1.0;
+    double d = 1.0 / clamp(1.0 - (a + b) * x / (a + 1.0));
+    double h = d;
+
+    for(std::size_t m = 1; m <= 300; ++m){
+        double aa = m * (b - m) * x / ((a - 1.0 + 2 * m) * (a + 2 * m));
+
+        d = 1.0 / clamp(1.0 + aa * d);
+        c = clamp(1.0 + aa / c);
+        h *= d * c;
+
+        aa = -(a + m) * (a + b + m) * x / ((a + 2 * m) * (a + 1.0 + 2 * m));
+
+        d = 1.0 / clamp(1.0 + aa * d);
+        c = clamp(1.0 + aa / c);
+        h *= d * c;
+
+        if(std::abs(d * c - 1.0) < 1e-14){
+            break;
+        }
+    }
+
+    return h;
+}
+
+//Regularized incomplete beta function I_x(a, b)
+inline double incomplete_beta(double a, double b, double x){
+    if(x <= 0.0){
+        return 0.0;
+    } else if(x >= 1.0){
+        return 1.0;
+    }
+
+    double front = std::exp(std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b) + a * std::log(x) + b * std::log(1.0 - x));
+
+    //The fraction converges quickly only on one side of the mean
+    if(x < (a + 1.0) / (a + b + 2.0)){
+        return front * incomplete_beta_fraction(a, b, x) / a;
+    } else {
+        return 1.0 - front * incomplete_beta_fraction(b, a, 1.0 - x) / b;
+    }
+}
+
+//Welch's t-test from the summaries of the measures (stddev divided by n as
+//in the results). The effect size is Cohen's d
+inline significance_result welch_test(double mean1, double stddev1, std::size_t n1, double mean2, double stddev2, std::size_t n2){
+    if(n1 < 2 || n2 < 2){
+        return {1.0, 0.0};
+    }
+
+    double v1 = stddev1 * stddev1 * n1 / (n1 - 1);
+    double v2 = stddev2 * stddev2 * n2 / (n2 - 1);
+
+    double spread = std::sqrt((v1 + v2) / 2.0);
+    double effect = spread == 0.0 ? 0.0 : (mean2 - mean1) / spread;
+
+    double error = v1 / n1 + v2 / n2;
+
+    if(error == 0.0){
+        return {mean1 == mean2 ? 1.0 : 0.0, effect};
+    }
+
+    double t = (mean2 - mean1) / std::sqrt(error);
+
+    //Welch-Satterthwaite degrees of freedom
+    double df = error * error / ((v1 / n1) * (v1 / n1) / (n1 - 1) + (v2 / n2) * (v2 / n2) / (n2 - 1));
+
+    return {incomplete_beta(df / 2.0, 0.5, df / (df + t * t)), effect};
+}
+
+//A value observed count times, the raw samples have a count of one and the
+//buckets of the histograms are represented by their middle
+struct weighted_sample {
+    double value;
+    double count;
+};
+
+//Mann-Whitney U test with the normal approximation, corrected for ties.
+//The effect size is Cliff's delta: P(second > first) - P(second < first)
+inline significance_result mann_whitney_test(const std::vector<weighted_sample>& first, const std::vector<weighted_sample>& second){
+    struct tagged {
+        double value;
+        double count;
+        bool first;
+    };
+
+    std::vector<tagged> all;
+    all.reserve(first.size() + second.size());
+
+    double n1 = 0.0;
+    double n2 = 0.0;
+
+    for(auto& s : first){
+        all.push_back({s.value, s.count, true});
+        n1 += s.count;
+    }
+
+    for(auto& s : second){
+        all.push_back({s.value, s.count, false});
+        n2 += s.count;
+    }
+
+    if(n1 == 0.0 || n2 == 0.0){
+        return {1.0, 0.0};
+    }
+
+    std::sort(all.begin(), all.end(), [](const tagged& lhs, const tagged& rhs){ return lhs.value < rhs.value; });
+
+    double rank_sum = 0.0; //ranks of the first set
+    double ties = 0.0;
+    double seen = 0.0;
+
+    for(std::size_t i = 0; i < all.size();){
+        double count = 0.0;
+        double count_first = 0.0;
+
+        std::size_t j = i;
+        for(; j < all.size() && all[j].value == all[i].value; ++j){
+            count += all[j].count;
+            count_first += all[j].first ? all[j].count : 0.0;
+        }
+
+        //Equal values share the mean of their ranks
+        rank_sum += count_first * (seen + (count + 1.0) / 2.0);
+        ties += count * count * count - count;
+
+        seen += count;
+        i = j;
+    }
+
+    double u1 = rank_sum - n1 * (n1 + 1.0) / 2.0;
+    double n = n1 + n2;
+
+    double mean = n1 * n2 / 2.0;
+    double variance = n1 * n2 / 12.0 * ((n + 1.0) - ties / (n * (n - 1.0)));
+
+    double effect = (n1 * n2 - 2.0 * u1) / (n1 * n2);
+
+    if(variance <= 0.0){
+        return {1.0, effect};
+    }
+
+    double z = std::max(0.0, std::abs(u1 - mean) - 0.5) / std::sqrt(variance);
+
+    return {std::erfc(z / std::sqrt(2.0)), effect};
+}
+
+//Optimal segmentation of a series in segments of different means with PELT
+//(Killick et al. 2012). The cost of a segment is its sum of squared
+//deviations in units of the noise, each change costs penalty. Returns the
+//start of each segment after the first one
+inline std::vector<std::size_t> pelt(const std::vector<double>& values, double sigma, double penalty, std::size_t min_size){
+    const std::size_t n = values.size();
+
+    std::vector<double> sum(n + 1, 0.0);
+    std::vector<double> squares(n + 1, 0.0);
+
+    for(std::size_t i = 0; i < n; ++i){
+        sum[i + 1] = sum[i] + values[i];
+        squares[i + 1] = squares[i] + values[i] * values[i];
+    }
+
+    auto cost = [&](std::size_t s, std::size_t t){
+        double segment = sum[t] - sum[s];
+        return std::max(0.0, squares[t] - squares[s] - segment * segment / (t - s)) / (sigma * sigma);
+    };
+
+    const double infinity = std::numeric_limits<double>::infinity();
+
+    std::vector<double> best(n + 1, infinity);
+    std::vector<std::size_t> last(n + 1, 0);
+    std::vector<std::size_t> candidates{0};
+
+    best[0] = -penalty;
+
+    for(std::size_t t = min_size; t <= n; ++t){
+        for(auto s : candidates){
+            if(t - s >= min_size && best[s] + cost(s, t) + penalty < best[t]){
+                best[t] = best[s] + cost(s, t) + penalty;
+                last[t] = s;
+            }
+        }
+
+        //A start that cannot beat t now never will
+        std::vector<std::size_t> kept;
+
+        for(auto s : candidates){
+            if(t - s < min_size || best[s] + cost(s, t) <= best[t]){
+                kept.push_back(s);
+            }
+        }
+
+        kept.push_back(t + 1 - min_size);
+
+        candidates.swap(kept);
+    }
+
+    std::vector<std::size_t> changes;
+
+    for(std::size_t t = n; t > 0 && last[t] > 0; t = last[t]){
+        changes.push_back(last[t]);
+    }
+
+    std::reverse(changes.begin(), changes.end());
+
+    return changes;
+}
+
+//A step in a series: the median of the segments before and after index
+struct change_point {
+    std::size_t index;
+    double before;
+    double after;
+};
+
+//Steps of at least min_change relative to the previous segment. A single
+//outlier is not a step: the series is smoothed by a running median of three
+//values before the segmentation. The noise is estimated from the
+//differences between successive values so that the steps do not inflate it
+inline std::vector<change_point> change_points(const std::vector<double>& values, double min_change){
+    std::vector<change_point> points;
+
+    if(values.size() < 4){
+        return points;
+    }
+
+    std::vector<double> smooth(values);
+
+    for(std::size_t i = 1; i + 1 < values.size(); ++i){
+        smooth[i] = std::max(std::min(values[i - 1], values[i]), std::min(std::max(values[i - 1], values[i]), values[i + 1]));
+    }
+
+    std::vector<double> differences;
+    for(std::size_t i = 1; i < values.size(); ++i){
+        differences.push_back(std::abs(values[i] - values[i - 1]));
+    }
+
+    std::sort(differences.begin(), differences.end());
+
+    //The median absolute difference of two normal values is 0.954 sigma
+    double sigma = percentile(differences, 0.5) / 0.954;
+
+    double scale = 0.0;
+    for(auto value : values){
+        scale = std::max(scale, std::abs(value));
+    }
+
+    sigma = std::max(sigma, 1e-9 * scale);
+
+    if(sigma == 0.0){
+        return points;
+    }
+
+    //Penalty of the MBIC, conservative so that the noise is not segmented
+    auto changes = pelt(smooth, sigma, 3.0 * std::log(double(values.size())), 2);
+
+    auto median = [&](std::size_t first, std::size_t last){
+        std::vector<double> segment(values.begin() + first, values.begin() + last);
+        std::sort(segment.begin(), segment.end());
+        return percentile(segment, 0.5);
+    };
+
+    //Small steps are merged with the previous segment
+    std::size_t start = 0;
+
+    for(std::size_t i = 0; i < changes.size(); ++i){
+        auto end = i + 1 < changes.size() ? changes[i + 1] : values.size();
+
+        double before = median(start, changes[i]);
+        double after = median(changes[i], end);
+
+        if(before != 0.0 && std::abs(after / before - 1.0) >= min_change){
+            points.push_back({changes[i], before, after});
+            start = changes[i];
+        }
+    }
+
+    return points;
+}
+
+//Least-squares fit of the times of a sweep against time = coefficient * f(n)
+struct complexity_fit {
+    const char* name = nullptr; //Class of the best fit, null with less than three sizes
+    double coefficient = 0.0;   //Time per unit of f(n)
+    double rms = 0.0;           //Root mean square of the residuals relative to the mean time
+};
+
+inline constexpr std::pair<const char*, double (*)(double)> complexity_classes[] = {
+    {"O(1)", [](double){ return 1.0; }},
+    {"O(log n)", [](double n){ return std::log2(n); }},
+    {"O(n)", [](double n){ return n; }},
+    {"O(n log n)", [](double n){ return n * std::log2(n); }},
+    {"O(n^2)", [](double n){ return n * n; }},
+    {"O(n^3)", [](double n){ return n * n * n; }}
+};
+
+//The class with the smallest residuals is the best fit, the simplest one
+//wins the ties
+inline complexity_fit fit_complexity(const std::vector<double>& sizes, const std::vector<double>& times){
+    complexity_fit best;
+
+    auto n = std::min(sizes.size(), times.size());
+
+    std::vector<double> distinct(sizes.begin(), sizes.begin() + n);
+    std::sort(distinct.begin(), distinct.end());
+    distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+
+    if(distinct.size() < 3 || distinct.front() < 1.0){
+        return best;
+    }
+
+    double mean = 0.0;
+    for(std::size_t i = 0; i < n; ++i){
+        mean += times[i] / n;
+    }
+
+    if(mean <= 0.0){
+        return best;
+    }
+
+    for(auto& complexity : complexity_classes){
+        double ft = 0.0;
+        double ff = 0.0;
+
+        for(std::size_t i = 0; i < n; ++i){
+            auto f = complexity.second(sizes[i]);
+            ft += f * times[i];
+            ff += f * f;
+        }
+
+        if(ff == 0.0){
+            continue;
+        }
+
+        double coefficient = ft / ff;
+        double residuals = 0.0;
+
+        for(std::size_t i = 0; i < n; ++i){
+            auto error = times[i] - coefficient * complexity.second(sizes[i]);
+            residuals += error * error;
+        }
+
+        double rms = std::sqrt(residuals / n) / mean;
+
+        if(!best.name || rms < best.rms){
+            best = {complexity.first, coefficient, rms};
+        }
+    }
+
+    return best;
+}
+
+} //end of namespace cpm
+
+#endif //CPM_STATISTICS_HPP
@@ -10,10 +10,15 @@
 #include <vector>
 #include <algorithm>
 #include <set>
+#include <limits>
+#include <cmath>
 #include <regex>
+#include <map>
+#include <memory>
 
 #include <stdio.h>
 #include <dirent.h>
+#include <sys/stat.h>
 
 #include "cxxopts.hpp"
 
@@ -24,6 +29,9 @@
 #include "cpm/bootstrap_theme.hpp"
 #include "cpm/bootstrap_tabs_theme.hpp"
 #include "cpm/duration.hpp"
+#include "cpm/histogram.hpp"
+#include "cpm/samples.hpp"
+#include "cpm/columns.hpp"
 
 namespace {
 
@@ -60,7 +68,341 @@ bool strip_equal(const std::string& lhs, const std::string& rhs){
     return strip_tags(lhs) == strip_tags(rhs);
 }
 
-cpm::document_t read_document(const std::string& folder, const std::string& file){
+//Statistics of the durations that can be charted (and their display names)
+const std::vector<std::pair<const char*, const char*>> statistics {
+    {"mean", "Mean"},
+    {"median", "Median"},
+    {"p90", "P90"},
+    {"p99", "P99"},
+    {"p999", "P99.9"},
+    {"min", "Min"},
+    {"max", "Max"},
+    {"stddev", "Stddev"},
+    {"mad", "MAD"},
+    {"iqr", "IQR"}
+};
+
+bool is_statistic(const std::string& name){
+    for(auto& statistic : statistics){
+        if(name == statistic.first){
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool is_samples_file(const std::string& file){
+    return file.size() > 8 && file.compare(file.size() - 8, 8, ".samples") == 0;
+}
+
+bool is_binary_file(const std::string& file){
+    return file.size() > 5 && file.compare(file.size() - 5, 5, ".cpmb") == 0;
+}
+
+//Values of a measure kept in the index of a run: the statistics, then the
+//throughput
+std::size_t value_keys(){
+    return statistics.size() + 1;
+}
+
+const char* value_key(std::size_t k){
+    return k < statistics.size() ? statistics[k].first : "throughput_f";
+}
+
+//Measures of a bench, or of an implementation of a section, in a run
+struct run_series {
+    std::string name;       //Without the tags
+    std::string complexity; //Empty if it has not been fitted
+    std::vector<std::string> sizes;
+    std::vector<double> values; //value_keys() values per size
+
+    double value(std::size_t size, std::size_t key) const {
+        return values[size * value_keys() + key];
+    }
+};
+
+struct run_section {
+    std::string name; //Without the tags
+    std::vector<run_series> implementations;
+};
+
+//Hot fields of a run, read with the run. The history of the measures goes
+//through all the runs of the folder and only needs these ones, the measures
+//of a binary run are only read if a page shows them
+struct run_index {
+    std::vector<run_series> benches;
+    std::vector<run_section> sections;
+    std::string file; //Binary results whose measures have not been read yet
+};
+
+std::vector<run_index>& run_indexes(){
+    static std::vector<run_index> indexes;
+    return indexes;
+}
+
+//The document of a run has the position of its index as "run" member
+const run_index& index_of(const cpm::document_t& doc){
+    return run_indexes()[doc["run"].GetInt()];
+}
+
+void add_index(cpm::document_t& doc, run_index index){
+    rapidjson::Value key(rapidjson::StringRef("run"));
+    rapidjson::Value value(static_cast<int>(run_indexes().size()));
+    doc.AddMember(key, value, doc.GetAllocator());
+
+    run_indexes().push_back(std::move(index));
+}
+
+template<typename T>
+run_series index_series(const T& measure, const char* name){
+    run_series series;
+    series.name = strip_tags(measure[name].GetString());
+
+    if(measure.HasMember("complexity")){
+        series.complexity = measure["complexity"].GetString();
+    }
+
+    for(auto& r : measure["results"]){
+        series.sizes.emplace_back(r["size"].GetString());
+
+        //Results saved before the robust statistics only have the mean
+        for(std::size_t k = 0; k < value_keys(); ++k){
+            series.values.push_back(r.HasMember(value_key(k)) ? r[value_key(k)].GetDouble() : r["mean"].GetDouble());
+        }
+    }
+
+    return series;
+}
+
+run_index index_document(const cpm::document_t& doc){
+    run_index index;
+
+    if(doc.HasMember("results")){
+        for(auto& result : doc["results"]){
+            index.benches.push_back(index_series(result, "title"));
+        }
+    }
+
+    if(doc.HasMember("sections")){
+        for(auto& section : doc["sections"]){
+            run_section indexed;
+            indexed.name = strip_tags(section["name"].GetString());
+
+            for(auto& r : section["results"]){
+                indexed.implementations.push_back(index_series(r, "name"));
+            }
+
+            index.sections.push_back(std::move(indexed));
+        }
+    }
+
+    return index;
+}
+
+std::string column_string(const cpm::column_file& file, std::size_t t, std::size_t row, const char* member){
+    auto* column = file.find(t, member, row);
+    return column && column->type == cpm::column_type::STRING ? std::string(file.string(*column, row)) : std::string();
+}
+
+//Sizes and values of the count rows of the table t from first, with a single
+//pass over the columns of the table
+void index_values(const cpm::column_file& file, std::size_t t, std::size_t first, std::size_t count, run_series& series){
+    series.sizes.resize(count);
+    series.values.assign(count * value_keys(), std::numeric_limits<double>::quiet_NaN());
+
+    for(std::size_t c = 0; c < file.columns(t); ++c){
+        auto& column = file.column(t, c);
+        auto name = file.name(column);
+
+        if(name == "size" && column.type == cpm::column_type::STRING){
+            for(std::size_t r = 0; r < count; ++r){
+                if(file.present(column, first + r)){
+                    series.sizes[r] = file.string(column, first + r);
+                }
+            }
+
+            continue;
+        }
+
+        if(column.type != cpm::column_type::REAL && column.type != cpm::column_type::INTEGER){
+            continue;
+        }
+
+        for(std::size_t k = 0; k < value_keys(); ++k){
+            if(name == value_key(k)){
+                for(std::size_t r = 0; r < count; ++r){
+                    if(file.present(column, first + r)){
+                        series.values[r * value_keys() + k] = column.type == cpm::column_type::REAL
+                            ? file.real(column, first + r)
+                            : file.integer(column, first + r);
+                    }
+                }
+            }
+        }
+    }
+
+    //Results saved before the robust statistics only have the mean (the
+    //first value)
+    for(std::size_t r = 0; r < count; ++r){
+        for(std::size_t k = 1; k < value_keys(); ++k){
+            if(std::isnan(series.values[r * value_keys() + k])){
+                series.values[r * value_keys() + k] = series.values[r * value_keys()];
+            }
+        }
+    }
+}
+
+//Same as index_series for the measures listed in the "results" member of a
+//row of a binary file, read from the columns without building the objects
+void index_columns(const cpm::column_file& file, std::size_t t, std::size_t row, const char* name, std::vector<run_series>& index){
+    auto* measures = file.find(t, "results", row);
+
+    if(!measures || measures->type != cpm::column_type::TABLE){
+        return;
+    }
+
+    auto range = file.range(*measures, row);
+
+    for(std::size_t m = range.first; m < range.first + range.second; ++m){
+        run_series series;
+        series.name = strip_tags(column_string(file, measures->table, m, name));
+        series.complexity = column_string(file, measures->table, m, "complexity");
+
+        auto* results = file.find(measures->table, "results", m);
+
+        if(results && results->type == cpm::column_type::TABLE){
+            auto sizes = file.range(*results, m);
+            index_values(file, results->table, sizes.first, sizes.second, series);
+        }
+
+        index.push_back(std::move(series));
+    }
+}
+
+run_index index_columns(const cpm::column_file& file){
+    run_index index;
+
+    index_columns(file, 0, 0, "title", index.benches);
+
+    auto* sections = file.find(0, "sections", 0);
+
+    if(sections && sections->type == cpm::column_type::TABLE){
+        auto range = file.range(*sections, 0);
+
+        for(std::size_t s = range.first; s < range.first + range.second; ++s){
+            run_section indexed;
+            indexed.name = strip_tags(column_string(file, sections->table, s, "name"));
+
+            index_columns(file, sections->table, s, "name", indexed.implementations);
+
+            index.sections.push_back(std::move(indexed));
+        }
+    }
+
+    return index;
+}
+
+//Members of a row of a table of a binary results file as members of a JSON
+//object, only its scalars or only its arrays if needed. The strings are
+//copied, the file is not used once the document is built
+void column_members(const cpm::column_file& file, std::size_t t, std::size_t row, rapidjson::Value& object, cpm::document_t::AllocatorType& allocator, bool scalars, bool arrays){
+    for(std::size_t c = 0; c < file.columns(t); ++c){
+        auto& column = file.column(t, c);
+
+        if(!file.present(column, row)){
+            continue;
+        }
+
+        bool array = column.type == cpm::column_type::REALS || column.type == cpm::column_type::TABLE;
+
+        if(array ? !arrays : !scalars){
+            continue;
+        }
+
+        auto name = file.name(column);
+
+        rapidjson::Value key(name.data(), name.size(), allocator);
+        rapidjson::Value value;
+
+        switch(column.type){
+            case cpm::column_type::INTEGER:
+                value.SetInt64(file.integer(column, row));
+                break;
+            case cpm::column_type::REAL:
+                value.SetDouble(file.real(column, row));
+                break;
+            case cpm::column_type::BOOLEAN:
+                value.SetBool(file.boolean(column, row));
+                break;
+            case cpm::column_type::STRING: {
+                auto string = file.string(column, row);
+                value.SetString(string.data(), string.size(), allocator);
+                break;
+            }
+            case cpm::column_type::REALS: {
+                auto range = file.range(column, row);
+
+                value.SetArray();
+                value.Reserve(range.second, allocator);
+
+                for(std::size_t i = 0; i < range.second; ++i){
+                    value.PushBack(file.reals()[range.first + i], allocator);
+                }
+
+                break;
+            }
+            case cpm::column_type::TABLE: {
+                auto range = file.range(column, row);
+
+                value.SetArray();
+                value.Reserve(range.second, allocator);
+
+                for(std::size_t i = 0; i < range.second; ++i){
+                    rapidjson::Value sub;
+                    sub.SetObject();
+                    column_members(file, column.table, range.first + i, sub, allocator, true, true);
+                    value.PushBack(sub, allocator);
+                }
+
+                break;
+            }
+        }
+
+        object.AddMember(key, value, allocator);
+    }
+}
+
+//The runs of a folder are read lazily: only their index and their root
+//members, the measures are read when the run is materialized
+cpm::document_t read_binary_document(const std::string& path, bool lazy){
+    cpm::document_t doc;
+    cpm::column_file file;
+
+    if(!file.open(path)){
+        //An invalid file is reported as an empty document
+        doc.Parse("");
+        return doc;
+    }
+
+    auto index = index_columns(file);
+
+    if(lazy){
+        index.file = path;
+    }
+
+    doc.SetObject();
+    add_index(doc, std::move(index));
+    column_members(file, 0, 0, doc, doc.GetAllocator(), true, !lazy);
+
+    return doc;
+}
+
+cpm::document_t read_document(const std::string& folder, const std::string& file, bool lazy = false){
+    if(is_binary_file(file)){
+        return read_binary_document(folder + "/" + file, lazy);
+    }
+
     FILE* pFile = fopen((folder + "/" + file).c_str(), "rb");
     char buffer[65536];
 
@@ -68,10 +410,46 @@ cpm::document_t read_document(const std::string& folder, const std::string& file
     cpm::document_t doc;
     doc.ParseStream<0>(is);
 
+    if(!doc.HasParseError()){
+        add_index(doc, index_document(doc));
+    }
+
     return doc;
 }
 
-std::vector<cpm::document_t> read(const std::string& source_folder, cxxopts::Options& options){
+//Reads the measures of a run of a folder if they have not been read yet. It
+//adds members to the document, the references to its members must be taken
+//after it
+const cpm::document_t& materialize(const cpm::document_t& doc){
+    auto& index = run_indexes()[doc["run"].GetInt()];
+
+    if(!index.file.empty()){
+        //The documents themselves are not const, only the view of the pages
+        auto& run = const_cast<cpm::document_t&>(doc);
+
+        cpm::column_file file;
+
+        if(file.open(index.file)){
+            column_members(file, 0, 0, run, run.GetAllocator(), false, true);
+        } else {
+            std::cout << "Impossible to read document " << index.file << ": invalid binary results" << std::endl;
+
+            for(auto* member : {"results", "sections"}){
+                rapidjson::Value key(rapidjson::StringRef(member));
+                rapidjson::Value value;
+                value.SetArray();
+                run.AddMember(key, value, run.GetAllocator());
+            }
+        }
+
+        index.file.clear();
+    }
+
+    return doc;
+}
+
+//Read all the documents of the folder, in no particular order
+std::vector<cpm::document_t> read_folder(const std::string& source_folder){
     std::vector<cpm::document_t> documents;
 
     struct dirent* entry;
@@ -86,9 +464,12 @@ std::vector<cpm::document_t> read(const std::string& source_folder, cxxopts::Opt
             continue;
         }
 
-        if(entry->d_type == DT_REG){
-            intel_decltype_auto doc = read_document(source_folder, entry->d_name);
-            if(doc.HasParseError()){
+        //The raw samples are read lazily, when they are charted
+        if(entry->d_type == DT_REG && !is_samples_file(entry->d_name)){
+            intel_decltype_auto doc = read_document(source_folder, entry->d_name, true);
+            if(doc.HasParseError() && is_binary_file(entry->d_name)){
+                std::cout << "Impossible to read document " << entry->d_name << ": invalid binary results" << std::endl;
+            } else if(doc.HasParseError()){
                 std::cout
                     << "Impossible to read document " << entry->d_name << ":" << doc.GetErrorOffset()
                     << ", parse error: " << rapidjson::GetParseError_En(doc.GetParseError()) << std::endl;
@@ -98,6 +479,12 @@ std::vector<cpm::document_t> read(const std::string& source_folder, cxxopts::Opt
         }
     }
 
+    return documents;
+}
+
+std::vector<cpm::document_t> read(const std::string& source_folder, cxxopts::Options& options){
+    auto documents = read_folder(source_folder);
+
     if(options.count("sort-by-tag")){
         std::sort(documents.begin(), documents.end(),
             [](cpm::document_t& lhs, cpm::document_t& rhs){
@@ -171,6 +558,123 @@ void footer(Theme& theme){
     theme << "</html>\n";
 }
 
+bool system_flag(json_value result, const char* flag){
+    return result.HasMember(flag) && result[flag].GetBool();
+}
+
+//Title suffix for the results measured on a throttled or loaded machine
+std::string system_flags_str(json_value result){
+    std::string flags;
+
+    if(system_flag(result, "system_throttled")){
+        flags += " (throttled)";
+    }
+
+    if(system_flag(result, "system_loaded")){
+        flags += " (loaded)";
+    }
+
+    return flags;
+}
+
+//Runs without placement information were not pinned
+std::string placement_str(const cpm::document_t& doc){
+    return doc.HasMember("placement") ? doc["placement"].GetString() : "unpinned";
+}
+
+template<typename Theme>
+bool has_baseline(Theme& theme){
+    return theme.options.count("baseline") || theme.options.count("baseline-file");
+}
+
+//Run all the comparisons are made with instead of the previous and the
+//first runs: the last run with the --baseline tag or the --baseline-file
+//run, of the same compiler and configuration
+template<typename Theme>
+const cpm::document_t* find_baseline(Theme& theme, const cpm::document_t& base){
+    auto same = [&base](const cpm::document_t& doc){
+        return str_equal(doc["compiler"].GetString(), base["compiler"].GetString())
+            && str_equal(doc["configuration"].GetString(), base["configuration"].GetString());
+    };
+
+    const cpm::document_t* baseline = nullptr;
+
+    if(theme.options.count("baseline-file")){
+        for(auto& doc : theme.data.baselines){
+            if(same(doc)){
+                baseline = &doc;
+            }
+        }
+    } else if(theme.options.count("baseline")){
+        auto& tag = theme.options["baseline"].template as<std::string>();
+
+        for(auto& doc : theme.data.documents){
+            if(same(doc) && tag == doc["tag"].GetString()){
+                baseline = &doc;
+            }
+        }
+    }
+
+    return baseline ? &materialize(*baseline) : nullptr;
+}
+
+template<typename Theme>
+std::string baseline_label(Theme& theme){
+    if(theme.options.count("baseline-file")){
+        auto& file = theme.options["baseline-file"].template as<std::string>();
+        return file.substr(file.rfind('/') + 1);
+    }
+
+    return theme.options["baseline"].template as<std::string>();
+}
+
+//Peaks of the machine calibrated at the start of the run
+bool has_peaks(const cpm::document_t& doc){
+    return doc.HasMember("peak_triad") && doc.HasMember("peak_flops_simd");
+}
+
+//Peak used to compare the runs of different machines, null without normalisation
+template<typename Theme>
+const char* normalize_key(Theme& theme){
+    if(!theme.options.count("normalize")){
+        return nullptr;
+    }
+
+    return theme.options["normalize"].template as<std::string>() == "bandwidth" ? "peak_triad" : "peak_flops_simd";
+}
+
+//Factor bringing a value of a run to the machine of the last calibrated run.
+//A time scales with the inverse of the peak and a throughput with the peak
+template<typename Theme>
+double normalization(Theme& theme, const cpm::document_t& doc){
+    auto key = normalize_key(theme);
+
+    if(!key || !doc.HasMember(key)){
+        return 1.0;
+    }
+
+    const cpm::document_t* reference = nullptr;
+
+    for(auto& other : theme.data.documents){
+        if(other.HasMember(key)){
+            reference = &other;
+        }
+    }
+
+    if(!reference){
+        return 1.0;
+    }
+
+    double ratio = (*reference)[key].GetDouble() / doc[key].GetDouble();
+
+    return theme.options.count("mflops-graphs") ? ratio : 1.0 / ratio;
+}
+
+template<typename Theme>
+bool changes_enabled(Theme& theme){
+    return !theme.options.count("disable-changes") && !theme.options.count("disable-time") && theme.data.documents.size() > 1;
+}
+
 template<typename Theme>
 void information(Theme& theme, const cpm::document_t& doc){
     theme.before_information(doc["name"].GetString());
@@ -179,8 +683,118 @@ void information(Theme& theme, const cpm::document_t& doc){
     theme << "<li>Compiler: " << doc["compiler"].GetString() << "</li>\n";
     theme << "<li>Configuration: " << doc["configuration"].GetString() << "</li>\n";
     theme << "<li>Operating System: " << doc["os"].GetString() << "</li>\n";
+
+    if(doc.HasMember("clock")){
+        if(doc.HasMember("clock_frequency")){
+            theme << "<li>Clock: " << doc["clock"].GetString() << " (" << cpm::to_string_precision(doc["clock_frequency"].GetDouble(), 4) << "GHz)</li>\n";
+        } else {
+            theme << "<li>Clock: " << doc["clock"].GetString() << "</li>\n";
+        }
+    }
+
+    if(doc.HasMember("clock_overhead")){
+        theme << "<li>Timer overhead: " << cpm::duration_str(doc["clock_overhead"].GetDouble(), 3)
+            << (doc["overhead_subtracted"].GetBool() ? " (subtracted)" : "")
+            << ", resolution: " << cpm::duration_str(doc["clock_resolution"].GetDouble(), 3) << "</li>\n";
+    }
+    theme << "<li>Placement: " << placement_str(doc) << "</li>\n";
+
+    //Runs without the method used the normal approximation
+    if(doc.HasMember("ci_method") && str_equal(doc["ci_method"].GetString(), "bootstrap")){
+        theme << "<li>Confidence intervals: bootstrap (" << doc["ci_resamples"].GetInt() << " resamples, seed " << doc["ci_seed"].GetInt() << ")</li>\n";
+    } else {
+        theme << "<li>Confidence intervals: normal approximation</li>\n";
+    }
+
+    if(has_peaks(doc)){
+        theme << "<li>Peaks: triad " << cpm::throughput_str(doc["peak_triad"].GetDouble(), 3) << "B/s, "
+            << cpm::throughput_str(doc["peak_flops_scalar"].GetDouble(), 3) << "Flop/s scalar, "
+            << cpm::throughput_str(doc["peak_flops_simd"].GetDouble(), 3) << "Flop/s SIMD";
+
+        if(doc.HasMember("peak_threads") && doc["peak_threads"].GetInt() > 1){
+            theme << " (" << doc["peak_threads"].GetInt() << " cores: triad " << cpm::throughput_str(doc["peak_triad_all"].GetDouble(), 3) << "B/s, "
+                << cpm::throughput_str(doc["peak_flops_simd_all"].GetDouble(), 3) << "Flop/s SIMD)";
+        }
+
+        theme << "</li>\n";
+    }
+
+    if(auto key = normalize_key(theme)){
+        if(doc.HasMember(key)){
+            theme << "<li>The other runs are normalised with their peak " << theme.options["normalize"].template as<std::string>() << "</li>\n";
+        } else {
+            theme << "<li><strong>Warning</strong>: this run has no peaks, the other runs cannot be normalised</li>\n";
+        }
+    }
+
+    if(doc.HasMember("governor")){
+        theme << "<li>Governor: " << doc["governor"].GetString() << "</li>\n";
+    }
+
+    //Results measured while the machine was throttling or loaded
+    std::size_t throttled = 0;
+    std::size_t loaded = 0;
+
+    for(auto& result : doc["results"]){
+        throttled += system_flag(result, "system_throttled");
+        loaded += system_flag(result, "system_loaded");
+    }
+
+    for(auto& section : doc["sections"]){
+        throttled += system_flag(section, "system_throttled");
+        loaded += system_flag(section, "system_loaded");
+    }
+
+    if(throttled){
+        theme << "<li><strong>Warning</strong>: the CPU was throttled during " << throttled << " benchmarks</li>\n";
+    }
+
+    if(loaded){
+        theme << "<li><strong>Warning</strong>: the machine was loaded during " << loaded << " benchmarks</li>\n";
+    }
+
+    //The compared runs must have been measured in the same conditions
+    std::set<std::string> placements;
+
+    for(auto& other : theme.data.documents){
+        if(placement_str(other) != placement_str(doc)){
+            placements.insert(placement_str(other));
+        }
+    }
+
+    if(!placements.empty()){
+        theme << "<li><strong>Warning</strong>: compared with runs using a different placement (";
+
+        std::string comma = "";
+        for(auto& placement : placements){
+            theme << comma << placement;
+            comma = "; ";
+        }
+
+        theme << ")</li>\n";
+    }
+
+    if(doc.HasMember("failures")){
+        for(auto& failure : doc["failures"]){
+            theme << "<li><strong>Failed</strong>: " << (failure["section"].GetBool() ? "section " : "bench ")
+                << failure["title"].GetString() << " (" << failure["reason"].GetString() << ")</li>\n";
+        }
+    }
+
     theme << "<li>Time: " << doc["time"].GetString() << "</li>\n";
 
+    if(changes_enabled(theme)){
+        theme << "<li><a href=\"changes.html\">Change points in the history</a></li>\n";
+    }
+
+    if(has_baseline(theme)){
+        if(auto* baseline = find_baseline(theme, doc)){
+            theme << "<li>Baseline: " << (*baseline)["tag"].GetString() << " (" << (*baseline)["time"].GetString() << ")</li>\n";
+        } else {
+            theme << "<li><strong>Warning</strong>: no baseline " << baseline_label(theme) << " for this compiler and configuration</li>\n";
+        }
+    }
+
     theme.after_information();
 }
 
@@ -221,13 +835,21 @@ void end_graph(Theme& theme){
 }
 
 template<typename Theme>
-void y_axis_configuration(Theme& theme){
+const char* value_key_name(Theme& theme);
+
+template<typename Theme>
+const char* statistic_name(Theme& theme);
+
+template<typename Theme>
+void y_axis_configuration(Theme& theme){
     theme << "yAxis: {\n";
 
     if(theme.options.count("mflops-graphs")){
         theme << "title: { text: 'Throughput [MFlops/s]' },\n";
-    } else {
+    } else if(str_equal(value_key_name(theme), "mean")){
         theme << "title: { text: 'Time [ns]' },\n";
+    } else {
+        theme << "title: { text: 'Time (" << statistic_name(theme) << ") [ns]' },\n";
     }
 
     theme << "plotLines: [{ value: 0, width: 1, color: '#808080'}]\n";
@@ -297,13 +919,246 @@ template<typename Theme>
 const char* value_key_name(Theme& theme){
     if(theme.options.count("mflops-graphs")){
         return "throughput_f";
-    } else {
-        return "mean";
+    }
+
+    auto& name = theme.options["statistic"].template as<std::string>();
+
+    for(auto& statistic : statistics){
+        if(name == statistic.first){
+            return statistic.first;
+        }
+    }
+
+    return "mean";
+}
+
+template<typename Theme>
+const char* statistic_name(Theme& theme){
+    auto key = value_key_name(theme);
+
+    for(auto& statistic : statistics){
+        if(str_equal(key, statistic.first)){
+            return statistic.second;
+        }
+    }
+
+    return key;
+}
+
+//Position of the charted value in the index of the runs
+template<typename Theme>
+std::size_t value_key_index(Theme& theme){
+    auto key = value_key_name(theme);
+
+    for(std::size_t k = 0; k < value_keys(); ++k){
+        if(str_equal(value_key(k), key)){
+            return k;
+        }
+    }
+
+    return 0;
+}
+
+//Results saved before the robust statistics only have the mean
+template<typename Theme>
+double statistic_value(Theme& theme, const rapidjson::Value& result){
+    auto key = value_key_name(theme);
+    return result.HasMember(key) ? result[key].GetDouble() : result["mean"].GetDouble();
+}
+
+template<typename Theme, typename T>
+std::vector<double> statistic_collect(Theme& theme, const T& parent){
+    std::vector<double> values;
+    for(auto& r : parent){
+        values.emplace_back(statistic_value(theme, r));
+    }
+    return values;
+}
+
+//Statistic of the results at each of the given sizes, null where the size
+//has not been measured
+template<typename Theme, typename T>
+std::vector<std::string> statistic_align(Theme& theme, const std::vector<std::string>& sizes, const T& parent){
+    std::vector<std::string> values;
+    for(auto& size : sizes){
+        std::string value = "null";
+        for(auto& r : parent){
+            if(strip_equal(r["size"].GetString(), size.c_str())){
+                std::ostringstream out;
+                out << statistic_value(theme, r);
+                value = out.str();
+                break;
+            }
+        }
+        values.push_back(value);
+    }
+    return values;
+}
+
+//Hardware counters (and their display names) that can be stored in a result
+const std::vector<std::pair<const char*, const char*>> counter_columns {
+    {"ipc", "IPC"},
+    {"l1d_misses", "L1D misses"},
+    {"llc_misses", "LLC misses"},
+    {"branch_misses", "Branch misses"}
+};
+
+bool has_member(json_value results, const char* attr){
+    for(auto& r : results){
+        if(r.HasMember(attr)){
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool has_counters(json_value results){
+    for(auto& counter : counter_columns){
+        if(has_member(results, counter.first)){
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool section_has_counters(json_value section){
+    for(auto& r : section["results"]){
+        if(has_counters(r["results"])){
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template<typename Theme>
+bool counters_enabled(Theme& theme, json_value results){
+    return !theme.options.count("disable-counters") && has_counters(results);
+}
+
+//Collect a value that may not be present in all the results (null in the graphs)
+template<typename T>
+std::vector<std::string> optional_collect(const T& parent, const char* attr){
+    std::vector<std::string> values;
+    for(auto& r : parent){
+        if(r.HasMember(attr)){
+            values.emplace_back(std::to_string(r[attr].GetDouble()));
+        } else {
+            values.emplace_back("null");
+        }
+    }
+    return values;
+}
+
+//Sum of values that may not be present in all the results, scaled for display
+template<typename T>
+std::vector<std::string> sum_collect(const T& parent, std::initializer_list<const char*> attrs, double scale = 1.0){
+    std::vector<std::string> values;
+    for(auto& r : parent){
+        if(r.HasMember(*attrs.begin())){
+            double sum = 0.0;
+            for(auto attr : attrs){
+                sum += r[attr].GetDouble();
+            }
+            values.emplace_back(std::to_string(sum * scale));
+        } else {
+            values.emplace_back("null");
+        }
+    }
+    return values;
+}
+
+template<typename Theme>
+bool resources_enabled(Theme& theme, json_value results){
+    return !theme.options.count("disable-resources") && has_member(results, "minor_faults");
+}
+
+template<typename Theme>
+bool section_resources_enabled(Theme& theme, json_value section){
+    for(auto& r : section["results"]){
+        if(resources_enabled(theme, r["results"])){
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//Peak of the cores used by a result, the all-core peak for the parallel measures
+double peak_value(const cpm::document_t& doc, json_value r, const std::string& key){
+    auto all = key + "_all";
+
+    if(r.HasMember("threads") && r["threads"].GetInt() > 1 && doc.HasMember(all.c_str())){
+        return doc[all.c_str()].GetDouble();
+    }
+
+    return doc[key.c_str()].GetDouble();
+}
+
+struct efficiency_columns {
+    bool flops = false;     //throughput_f relative to the SIMD flops peak
+    bool bandwidth = false; //throughput_b relative to the triad peak
+};
+
+//The flops are only meaningful when the summary is in flops
+template<typename Theme>
+efficiency_columns efficiency_enabled(Theme& theme, json_value results, const cpm::document_t& doc){
+    efficiency_columns columns;
+
+    if(has_peaks(doc)){
+        columns.flops = theme.options.count("mflops");
+        columns.bandwidth = has_member(results, "throughput_b");
+    }
+
+    return columns;
+}
+
+template<typename Theme>
+void efficiency_cells(Theme& theme, json_value r, const cpm::document_t& doc, efficiency_columns columns){
+    if(columns.flops){
+        theme.cell(cpm::to_string_precision(100.0 * r["throughput_f"].GetDouble() / peak_value(doc, r, "peak_flops_simd"), 3) + "%");
+    }
+
+    if(columns.bandwidth){
+        if(r.HasMember("throughput_b")){
+            theme.cell(cpm::to_string_precision(100.0 * r["throughput_b"].GetDouble() / peak_value(doc, r, "peak_triad"), 3) + "%");
+        } else {
+            theme.cell("N/A");
+        }
+    }
+}
+
+template<typename Theme>
+void counters_cells(Theme& theme, json_value r){
+    for(auto& counter : counter_columns){
+        if(!r.HasMember(counter.first)){
+            theme.cell("N/A");
+        } else if(str_equal(counter.first, "ipc")){
+            theme.cell(cpm::to_string_precision(r[counter.first].GetDouble(), 3));
+        } else {
+            theme.cell(cpm::throughput_str(r[counter.first].GetDouble(), 3));
+        }
     }
 }
 
+template<typename Theme, typename T>
+void generate_baseline_series(Theme& theme, std::string& comma, const std::vector<std::string>& sizes, const T& results, const std::string& name){
+    theme << comma << "{\n";
+    theme << "name: '" << name << (name.empty() ? "" : " ") << "(baseline " << baseline_label(theme) << ")',\n";
+    theme << "dashStyle: 'ShortDash',\n";
+    theme << "data: ";
+
+    json_array_value(theme, statistic_align(theme, sizes, results));
+
+    theme << "\n}\n";
+
+    comma = ",";
+}
+
 template<typename Theme>
-void generate_run_graph(Theme& theme, std::size_t& id, const rapidjson::Value& result){
+void generate_run_graph(Theme& theme, std::size_t& id, const rapidjson::Value& result, const cpm::document_t& doc){
     theme.before_graph(id);
 
     std::string title = std::string("Last run") +
@@ -319,17 +1174,37 @@ void generate_run_graph(Theme& theme, std::size_t& id, const rapidjson::Value& r
 
     y_axis_configuration(theme);
 
-    theme << "legend: { enabled: false },\n";
+    const rapidjson::Value* baseline_result = nullptr;
+
+    if(auto* baseline = find_baseline(theme, doc)){
+        for(auto& r : (*baseline)["results"]){
+            if(strip_equal(r["title"].GetString(), result["title"].GetString())){
+                baseline_result = &r;
+            }
+        }
+    }
+
+    if(baseline_result){
+        theme << "legend: { align: 'left', verticalAlign: 'top', floating: false, borderWidth: 0, y: 20 },\n";
+    } else {
+        theme << "legend: { enabled: false },\n";
+    }
 
     theme << "series: [\n";
     theme << "{\n";
 
-    theme << "name: '',\n";
+    theme << "name: '" << (baseline_result ? doc["tag"].GetString() : "") << "',\n";
     theme << "data: ";
 
-    json_array_value(theme, double_collect(result["results"], value_key_name(theme)));
+    json_array_value(theme, statistic_collect(theme, result["results"]));
 
     theme << "\n}\n";
+
+    if(baseline_result){
+        std::string comma = ",";
+        generate_baseline_series(theme, comma, string_collect(result["results"], "size"), (*baseline_result)["results"], "");
+    }
+
     theme << "]\n";
 
     end_graph(theme);
@@ -337,42 +1212,47 @@ void generate_run_graph(Theme& theme, std::size_t& id, const rapidjson::Value& r
     ++id;
 }
 
-template<typename Theme, typename Filter>
-void generate_compare_graph(Theme& theme, std::size_t& id, json_value base_result, const std::string& title, const char* attr, Filter f){
+template<typename Theme>
+void generate_counters_graph(Theme& theme, std::size_t& id, const rapidjson::Value& result){
     theme.before_graph(id);
 
-    std::string graph_title = title +
-        (theme.options.count("pages") ? std::string() : std::string(": ") + strip_tags(base_result["title"].GetString()));
-    start_graph(theme, std::string("chart_") + std::to_string(id), graph_title);
+    std::string title = std::string("Counters") +
+        (theme.options.count("pages") ? std::string() : std::string(": ") + strip_tags(result["title"].GetString()));
+
+    start_graph(theme, std::string("chart_") + std::to_string(id), title);
 
     theme << "xAxis: { categories: \n";
 
-    json_array_string(theme, string_collect(base_result["results"], "size"));
+    json_array_string(theme, string_collect(result["results"], "size"));
 
     theme << "},\n";
 
-    y_axis_configuration(theme);
+    theme << "yAxis: [\n";
+    theme << "{ title: { text: 'Misses per call' }, min: 0 },\n";
+    theme << "{ title: { text: 'IPC' }, min: 0, opposite: true }\n";
+    theme << "],\n";
 
     theme << "legend: { align: 'left', verticalAlign: 'top', floating: false, borderWidth: 0, y: 20 },\n";
 
     theme << "series: [\n";
 
     std::string comma = "";
-    for(auto& document : theme.data.documents){
-        if(f(document)){
-            for(auto& result : document["results"]){
-                if(strip_equal(result["title"].GetString(), base_result["title"].GetString())){
-                    theme << comma << "{\n";
-                    theme << "name: '" << document[attr].GetString() << "',\n";
-                    theme << "data: ";
+    for(auto& counter : counter_columns){
+        if(has_member(result["results"], counter.first)){
+            theme << comma << "{\n";
+            theme << "name: '" << counter.second << "',\n";
 
-                    json_array_value(theme, double_collect(result["results"], value_key_name(theme)));
+            if(str_equal(counter.first, "ipc")){
+                theme << "yAxis: 1,\n";
+            }
 
-                    theme << "\n}\n";
+            theme << "data: ";
 
-                    comma = ",";
-                }
-            }
+            json_array_value(theme, optional_collect(result["results"], counter.first));
+
+            theme << "\n}\n";
+
+            comma = ",";
         }
     }
 
@@ -383,96 +1263,727 @@ void generate_compare_graph(Theme& theme, std::size_t& id, json_value base_resul
     ++id;
 }
 
-bool is_compiler_relevant(const cpm::document_t& base, const cpm::document_t& doc){
-    return  str_equal(doc["tag"].GetString(), base["tag"].GetString())
-        &&  str_equal(doc["configuration"].GetString(), base["configuration"].GetString());
-}
+//Performance of each size against its arithmetic intensity, on log scales.
+//Each series is a list of results (a bench or an implementation of a section)
+template<typename Theme>
+void generate_roofline_graph(Theme& theme, std::size_t& id, const std::string& name, const std::vector<std::pair<std::string, const rapidjson::Value*>>& series, const cpm::document_t& doc){
+    theme.before_graph(id);
 
-bool is_configuration_relevant(const cpm::document_t& base, const cpm::document_t& doc){
-    return  str_equal(doc["tag"].GetString(), base["tag"].GetString())
-        &&  str_equal(doc["compiler"].GetString(), base["compiler"].GetString());
-}
+    std::string title = std::string("Roofline") +
+        (theme.options.count("pages") ? std::string() : std::string(": ") + strip_tags(name));
 
-auto compiler_filter(const cpm::document_t& base){
-    return [&base](const cpm::document_t& doc){
-        return is_compiler_relevant(base, doc);
-    };
-}
+    start_graph(theme, std::string("chart_") + std::to_string(id), title);
 
-auto configuration_filter(const cpm::document_t& base){
-    return [&base](const cpm::document_t& doc){
-        return is_configuration_relevant(base, doc);
-    };
-}
+    theme << "chart: { type: 'scatter', zoomType: 'xy' },\n";
+    theme << "legend: { align: 'left', verticalAlign: 'top', floating: false, borderWidth: 0, y: 20 },\n";
+    theme << "xAxis: { type: 'logarithmic', title: { text: 'Arithmetic intensity [Flop/B]' } },\n";
+    theme << "yAxis: { type: 'logarithmic', title: { text: 'Performance [GFlop/s]' } },\n";
+    theme << "tooltip: { headerFormat: '{series.name}<br>', pointFormat: '{point.name}: {point.x:.3f}Flop/B, {point.y:.3f}GFlop/s' },\n";
+    theme << "plotOptions: { scatter: { lineWidth: 1 } },\n";
 
-template<typename Theme>
-void generate_compiler_graph(Theme& theme, std::size_t& id, const rapidjson::Value& base_result, const cpm::document_t& base){
-    generate_compare_graph(theme, id, base_result, "Compiler", "compiler", compiler_filter(base));
-}
+    theme << "series: [\n";
 
-template<typename Theme>
-void generate_configuration_graph(Theme& theme, std::size_t& id, const rapidjson::Value& base_result, const cpm::document_t& base){
-    generate_compare_graph(theme, id, base_result, "Configuration", "configuration", configuration_filter(base));
-}
+    std::string comma = "";
+    for(auto& s : series){
+        theme << comma << "{\n";
+        theme << "name: '" << s.first << "',\n";
+        theme << "data: [";
 
-template<typename Theme>
-std::pair<bool, double> find_same_duration(Theme& theme, const rapidjson::Value& base_result, const rapidjson::Value& r, const cpm::document_t& doc){
-    for(auto& p_r : doc["results"]){
-        if(strip_equal(p_r["title"].GetString(), base_result["title"].GetString())){
-            for(auto& p_r_r : p_r["results"]){
-                if(str_equal(p_r_r["size"].GetString(), r["size"].GetString())){
-                    return std::make_pair(true, p_r_r[value_key_name(theme)].GetDouble());
-                }
+        std::string inner_comma = "";
+        for(auto& r : *s.second){
+            if(r.HasMember("intensity") && r["intensity"].GetDouble() > 0.0 && r["throughput_f"].GetDouble() > 0.0){
+                theme << inner_comma << "{ x: " << r["intensity"].GetDouble()
+                    << ", y: " << r["throughput_f"].GetDouble() / (1000.0 * 1000.0 * 1000.0)
+                    << ", name: '" << r["size"].GetString() << "' }";
+                inner_comma = ",";
             }
         }
-    }
 
-    return std::make_pair(false, 0);
-}
+        theme << "]\n";
+        theme << "}\n";
 
-template<typename Theme>
-double add_compare_cell(Theme& theme, double current, double previous){
-    double diff = 0.0;
+        comma = ",";
+    }
 
-    if(theme.options.count("mflops-graphs")){
-        if(previous == 0.0){
-            if(current < 0.0){
-                theme.red_cell(std::to_string(current) + "%");
-            } else if(current > 0.0){
-                theme.green_cell("+" + std::to_string(current) + "%");
-            } else {
-                theme.cell("+0%");
-            }
-        } else {
-            if(current < previous){
-                diff = -1.0 * (100.0 * (static_cast<double>(previous) / current) - 100.0);
-                theme.red_cell(std::to_string(diff) + "%");
-            } else if(current > previous){
-                diff = 1.0 * (100.0 * (static_cast<double>(current) / previous) - 100.0);
-                theme.green_cell("+" + std::to_string(diff) + "%");
-            } else {
-                theme.cell("+0%");
-            }
+    //The roofs of the calibrated peaks, the bandwidth slope up to the ridge
+    //point and then the compute ceiling
+    if(has_peaks(doc)){
+        std::vector<std::pair<std::string, std::string>> roofs{{"1 core", ""}};
+
+        if(doc.HasMember("peak_threads") && doc["peak_threads"].GetInt() > 1){
+            roofs.emplace_back(std::to_string(doc["peak_threads"].GetInt()) + " cores", "_all");
         }
-    } else {
-        if(previous == 0.0){
-            if(current < 0.0){
-                theme.green_cell(std::to_string(current) + "%");
-            } else if(current > 0.0){
-                theme.red_cell("+" + std::to_string(current) + "%");
-            } else {
-                theme.cell("+0%");
-            }
-        } else {
-            if(current < previous){
-                diff = -1.0 * (100.0 * (static_cast<double>(previous) / current) - 100.0);
-                theme.green_cell(std::to_string(diff) + "%");
-            } else if(current > previous){
-                diff = 1.0 * (100.0 * (static_cast<double>(current) / previous) - 100.0);
-                theme.red_cell("+" + std::to_string(diff) + "%");
-            } else {
-                theme.cell("+0%");
-            }
+
+        for(auto& roof : roofs){
+            double bandwidth = doc[("peak_triad" + roof.second).c_str()].GetDouble() / (1000.0 * 1000.0 * 1000.0);
+            double flops = doc[("peak_flops_simd" + roof.second).c_str()].GetDouble() / (1000.0 * 1000.0 * 1000.0);
+            double ridge = flops / bandwidth;
+
+            theme << comma << "{\n";
+            theme << "name: 'Roof (" << roof.first << ")',\n";
+            theme << "type: 'line', dashStyle: 'Dash', marker: { enabled: false }, enableMouseTracking: false,\n";
+            theme << "data: [[" << ridge / 1000.0 << "," << bandwidth * ridge / 1000.0 << "],[" << ridge << "," << flops << "],[" << ridge * 1000.0 << "," << flops << "]]\n";
+            theme << "}\n";
+
+            comma = ",";
+        }
+    }
+
+    theme << "]\n";
+
+    end_graph(theme);
+    theme.after_graph();
+    ++id;
+}
+
+//Page faults and context switches during the sampling of each size, with
+//the growth of the peak RSS, which are all invisible in the timings
+template<typename Theme>
+void generate_resources_graph(Theme& theme, std::size_t& id, const rapidjson::Value& result){
+    theme.before_graph(id);
+
+    std::string title = std::string("Resources") +
+        (theme.options.count("pages") ? std::string() : std::string(": ") + strip_tags(result["title"].GetString()));
+
+    start_graph(theme, std::string("chart_") + std::to_string(id), title);
+
+    theme << "xAxis: { categories: \n";
+
+    json_array_string(theme, string_collect(result["results"], "size"));
+
+    theme << "},\n";
+
+    theme << "yAxis: [\n";
+    theme << "{ title: { text: 'Per measure' }, min: 0 },\n";
+    theme << "{ title: { text: 'Peak RSS growth [KB]' }, min: 0, opposite: true }\n";
+    theme << "],\n";
+
+    theme << "legend: { align: 'left', verticalAlign: 'top', floating: false, borderWidth: 0, y: 20 },\n";
+
+    theme << "series: [\n";
+
+    const std::vector<std::pair<const char*, const char*>> resources {
+        {"minor_faults", "Minor faults"},
+        {"major_faults", "Major faults"},
+        {"voluntary_switches", "Voluntary switches"},
+        {"involuntary_switches", "Involuntary switches"}
+    };
+
+    for(auto& resource : resources){
+        theme << "{\n";
+        theme << "name: '" << resource.second << "',\n";
+        theme << "type: 'column',\n";
+        theme << "data: ";
+
+        json_array_value(theme, optional_collect(result["results"], resource.first));
+
+        theme << "\n},\n";
+    }
+
+    theme << "{\n";
+    theme << "name: 'Peak RSS growth',\n";
+    theme << "yAxis: 1,\n";
+    theme << "tooltip: { valueSuffix: 'KB' },\n";
+    theme << "data: ";
+
+    json_array_value(theme, sum_collect(result["results"], {"rss_growth"}, 1.0 / 1024.0));
+
+    theme << "\n}\n";
+
+    theme << "]\n";
+
+    end_graph(theme);
+    theme.after_graph();
+    ++id;
+}
+
+//Aggregate and per-thread throughput of parallel measures
+template<typename Theme>
+void generate_threads_graph(Theme& theme, std::size_t& id, const rapidjson::Value& result){
+    theme.before_graph(id);
+
+    std::string title = std::string("Threads") +
+        (theme.options.count("pages") ? std::string() : std::string(": ") + strip_tags(result["title"].GetString()));
+
+    start_graph(theme, std::string("chart_") + std::to_string(id), title);
+
+    theme << "xAxis: { categories: \n";
+
+    json_array_string(theme, string_collect(result["results"], "size"));
+
+    theme << "},\n";
+
+    theme << "yAxis: [\n";
+    theme << "{ title: { text: 'Operations per second' }, min: 0 },\n";
+    theme << "{ title: { text: 'Fairness' }, min: 0, max: 1, opposite: true }\n";
+    theme << "],\n";
+
+    theme << "legend: { align: 'left', verticalAlign: 'top', floating: false, borderWidth: 0, y: 20 },\n";
+
+    std::vector<std::string> slowest;
+    std::vector<std::string> fastest;
+
+    for(auto& r : result["results"]){
+        if(r.HasMember("thread_results") && r["thread_results"].Size()){
+            double min = std::numeric_limits<double>::max();
+            double max = 0.0;
+
+            for(auto& t : r["thread_results"]){
+                min = std::min(min, t["ops"].GetDouble());
+                max = std::max(max, t["ops"].GetDouble());
+            }
+
+            slowest.push_back(std::to_string(min));
+            fastest.push_back(std::to_string(max));
+        } else {
+            slowest.emplace_back("null");
+            fastest.emplace_back("null");
+        }
+    }
+
+    theme << "series: [\n";
+
+    theme << "{\n";
+    theme << "name: 'Total',\n";
+    theme << "data: ";
+    json_array_value(theme, optional_collect(result["results"], "ops"));
+    theme << "\n},\n";
+
+    theme << "{\n";
+    theme << "name: 'Slowest thread',\n";
+    theme << "data: ";
+    json_array_value(theme, slowest);
+    theme << "\n},\n";
+
+    theme << "{\n";
+    theme << "name: 'Fastest thread',\n";
+    theme << "data: ";
+    json_array_value(theme, fastest);
+    theme << "\n},\n";
+
+    theme << "{\n";
+    theme << "name: 'Fairness',\n";
+    theme << "yAxis: 1,\n";
+    theme << "dashStyle: 'dash',\n";
+    theme << "data: ";
+    json_array_value(theme, optional_collect(result["results"], "fairness"));
+    theme << "\n}\n";
+
+    theme << "]\n";
+
+    end_graph(theme);
+    theme.after_graph();
+    ++id;
+}
+
+//State of the machine while a bench or a section was measured
+template<typename Theme>
+void generate_system_graph(Theme& theme, std::size_t& id, const rapidjson::Value& result, const std::string& name){
+    theme.before_graph(id);
+
+    std::string title = "System" + system_flags_str(result) +
+        (theme.options.count("pages") ? std::string() : std::string(": ") + strip_tags(name));
+
+    start_graph(theme, std::string("chart_") + std::to_string(id), title);
+
+    std::vector<std::string> times;
+    for(auto& t : result["system_time"]){
+        times.push_back(cpm::to_string_precision(t.GetDouble(), 3) + "s");
+    }
+
+    theme << "xAxis: { categories: \n";
+    json_array_string(theme, times);
+    theme << "},\n";
+
+    theme << "yAxis: [\n";
+    theme << "{ title: { text: 'Frequency [MHz]' }, min: 0 },\n";
+    theme << "{ title: { text: 'Temperature [C]' }, min: 0, opposite: true },\n";
+    theme << "{ title: { text: 'Load / steal and iowait [%]' }, min: 0, opposite: true }\n";
+    theme << "],\n";
+
+    theme << "legend: { align: 'left', verticalAlign: 'top', floating: false, borderWidth: 0, y: 20 },\n";
+
+    const std::vector<std::pair<const char*, const char*>> series {
+        {"system_mhz", "Frequency"},
+        {"system_temperature", "Temperature"},
+        {"system_load", "Load average"},
+        {"system_steal", "Steal"},
+        {"system_iowait", "IO wait"}
+    };
+
+    theme << "series: [\n";
+
+    std::string comma = "";
+    for(std::size_t i = 0; i < series.size(); ++i){
+        std::vector<double> values;
+        for(auto& v : result[series[i].first]){
+            values.push_back(v.GetDouble());
+        }
+
+        theme << comma << "{\n";
+        theme << "name: '" << series[i].second << "',\n";
+        theme << "yAxis: " << std::min(i, std::size_t(2)) << ",\n";
+        theme << "data: ";
+        json_array_value(theme, values);
+        theme << "\n}\n";
+
+        comma = ",";
+    }
+
+    theme << "]\n";
+
+    end_graph(theme);
+    theme.after_graph();
+    ++id;
+}
+
+//A run is a strong scaling run if the size of the problem does not change
+//with the number of threads, otherwise it is a weak scaling run
+bool is_strong_scaling(json_value results){
+    std::size_t work = 0;
+
+    for(auto& r : results){
+        if(!r.HasMember("work")){
+            return false;
+        }
+
+        if(work && std::size_t(r["work"].GetInt()) != work){
+            return false;
+        }
+
+        work = r["work"].GetInt();
+    }
+
+    return work;
+}
+
+struct scaling_data {
+    std::vector<std::string> threads;
+    std::vector<std::string> speedup;
+    std::vector<std::string> efficiency;
+    std::vector<std::string> ideal;
+};
+
+//Speedup and parallel efficiency relatively to the first run (usually one thread)
+scaling_data compute_scaling(json_value results){
+    scaling_data scaling;
+
+    bool strong = is_strong_scaling(results);
+
+    double base_threads = 0.0;
+    double base_wall = 0.0;
+
+    for(auto& r : results){
+        if(!r.HasMember("threads")){
+            continue;
+        }
+
+        double threads = r["threads"].GetInt();
+        double wall = r.HasMember("wall") ? r["wall"].GetDouble() : r["mean"].GetDouble();
+
+        if(base_threads == 0.0){
+            base_threads = threads;
+            base_wall = wall;
+        }
+
+        scaling.threads.push_back(std::to_string(r["threads"].GetInt()));
+        scaling.ideal.push_back(std::to_string(threads / base_threads));
+
+        if(wall > 0.0){
+            double speedup = strong ? base_wall / wall : (threads / base_threads) * (base_wall / wall);
+            scaling.speedup.push_back(std::to_string(speedup));
+            scaling.efficiency.push_back(std::to_string(speedup * base_threads / threads));
+        } else {
+            scaling.speedup.emplace_back("null");
+            scaling.efficiency.emplace_back("null");
+        }
+    }
+
+    return scaling;
+}
+
+template<typename Theme>
+void scaling_axis_configuration(Theme& theme, const std::vector<std::string>& threads){
+    theme << "xAxis: { title: { text: 'Threads' }, categories: \n";
+
+    json_array_string(theme, threads);
+
+    theme << "},\n";
+
+    theme << "yAxis: [\n";
+    theme << "{ title: { text: 'Speedup' }, min: 0 },\n";
+    theme << "{ title: { text: 'Parallel efficiency' }, min: 0, opposite: true }\n";
+    theme << "],\n";
+
+    theme << "legend: { align: 'left', verticalAlign: 'top', floating: false, borderWidth: 0, y: 20 },\n";
+}
+
+//Replaces the run graph for the parallel measures
+template<typename Theme>
+void generate_scaling_graph(Theme& theme, std::size_t& id, const rapidjson::Value& result){
+    theme.before_graph(id);
+
+    std::string title = std::string(is_strong_scaling(result["results"]) ? "Strong scaling" : "Weak scaling") +
+        (theme.options.count("pages") ? std::string() : std::string(": ") + strip_tags(result["title"].GetString()));
+
+    start_graph(theme, std::string("chart_") + std::to_string(id), title);
+
+    auto scaling = compute_scaling(result["results"]);
+
+    scaling_axis_configuration(theme, scaling.threads);
+
+    theme << "series: [\n";
+
+    theme << "{\n";
+    theme << "name: 'Speedup',\n";
+    theme << "data: ";
+    json_array_value(theme, scaling.speedup);
+    theme << "\n},\n";
+
+    theme << "{\n";
+    theme << "name: 'Ideal',\n";
+    theme << "dashStyle: 'dot',\n";
+    theme << "data: ";
+    json_array_value(theme, scaling.ideal);
+    theme << "\n},\n";
+
+    theme << "{\n";
+    theme << "name: 'Efficiency',\n";
+    theme << "yAxis: 1,\n";
+    theme << "dashStyle: 'dash',\n";
+    theme << "data: ";
+    json_array_value(theme, scaling.efficiency);
+    theme << "\n}\n";
+
+    theme << "]\n";
+
+    end_graph(theme);
+    theme.after_graph();
+    ++id;
+}
+
+template<typename Theme, typename Filter>
+void generate_compare_graph(Theme& theme, std::size_t& id, json_value base_result, const std::string& title, const char* attr, Filter f){
+    theme.before_graph(id);
+
+    std::string graph_title = title +
+        (theme.options.count("pages") ? std::string() : std::string(": ") + strip_tags(base_result["title"].GetString()));
+    start_graph(theme, std::string("chart_") + std::to_string(id), graph_title);
+
+    theme << "xAxis: { categories: \n";
+
+    json_array_string(theme, string_collect(base_result["results"], "size"));
+
+    theme << "},\n";
+
+    y_axis_configuration(theme);
+
+    theme << "legend: { align: 'left', verticalAlign: 'top', floating: false, borderWidth: 0, y: 20 },\n";
+
+    theme << "series: [\n";
+
+    std::string comma = "";
+    for(auto& document : theme.data.documents){
+        if(f(document)){
+            for(auto& result : materialize(document)["results"]){
+                if(strip_equal(result["title"].GetString(), base_result["title"].GetString())){
+                    theme << comma << "{\n";
+                    theme << "name: '" << document[attr].GetString() << "',\n";
+                    theme << "data: ";
+
+                    json_array_value(theme, statistic_collect(theme, result["results"]));
+
+                    theme << "\n}\n";
+
+                    comma = ",";
+                }
+            }
+
+            if(auto* baseline = find_baseline(theme, document)){
+                for(auto& result : (*baseline)["results"]){
+                    if(strip_equal(result["title"].GetString(), base_result["title"].GetString())){
+                        generate_baseline_series(theme, comma, string_collect(base_result["results"], "size"), result["results"], document[attr].GetString());
+                    }
+                }
+            }
+        }
+    }
+
+    theme << "]\n";
+
+    end_graph(theme);
+    theme.after_graph();
+    ++id;
+}
+
+bool is_compiler_relevant(const cpm::document_t& base, const cpm::document_t& doc){
+    return  str_equal(doc["tag"].GetString(), base["tag"].GetString())
+        &&  str_equal(doc["configuration"].GetString(), base["configuration"].GetString());
+}
+
+bool is_configuration_relevant(const cpm::document_t& base, const cpm::document_t& doc){
+    return  str_equal(doc["tag"].GetString(), base["tag"].GetString())
+        &&  str_equal(doc["compiler"].GetString(), base["compiler"].GetString());
+}
+
+auto compiler_filter(const cpm::document_t& base){
+    return [&base](const cpm::document_t& doc){
+        return is_compiler_relevant(base, doc);
+    };
+}
+
+auto configuration_filter(const cpm::document_t& base){
+    return [&base](const cpm::document_t& doc){
+        return is_configuration_relevant(base, doc);
+    };
+}
+
+template<typename Theme>
+void generate_compiler_graph(Theme& theme, std::size_t& id, const rapidjson::Value& base_result, const cpm::document_t& base){
+    generate_compare_graph(theme, id, base_result, "Compiler", "compiler", compiler_filter(base));
+}
+
+template<typename Theme>
+void generate_configuration_graph(Theme& theme, std::size_t& id, const rapidjson::Value& base_result, const cpm::document_t& base){
+    generate_compare_graph(theme, id, base_result, "Configuration", "configuration", configuration_filter(base));
+}
+
+//A latency histogram to chart and its name in the legend
+using histogram_series = std::pair<std::string, const rapidjson::Value*>;
+
+template<typename Theme>
+void histogram_graph_start(Theme& theme, std::size_t& id, const std::string& kind, const std::string& name){
+    theme.before_graph(id);
+
+    std::string title = kind +
+        (theme.options.count("pages") ? std::string() : std::string(": ") + strip_tags(name));
+
+    start_graph(theme, std::string("chart_") + std::to_string(id), title);
+
+    theme << "legend: { align: 'left', verticalAlign: 'top', floating: false, borderWidth: 0, y: 20 },\n";
+}
+
+//Share of the samples in each bucket of the histograms
+template<typename Theme>
+void generate_distribution_graph(Theme& theme, std::size_t& id, const std::string& name, const std::vector<histogram_series>& series){
+    histogram_graph_start(theme, id, "Distribution", name);
+
+    theme << "xAxis: { type: 'logarithmic', title: { text: 'Time [ns]' } },\n";
+    theme << "yAxis: { title: { text: 'Samples [%]' }, min: 0 },\n";
+    theme << "tooltip: { headerFormat: '{point.x:.3f}ns<br>', pointFormat: '{series.name}: {point.y:.3f}%' },\n";
+
+    theme << "series: [\n";
+
+    std::string comma = "";
+    for(auto& s : series){
+        auto buckets = cpm::decode_histogram((*s.second)["histogram"].GetString());
+
+        uint64_t total = 0;
+        for(auto& bucket : buckets){
+            total += bucket.count;
+        }
+
+        theme << comma << "{\n";
+        theme << "name: '" << s.first << "',\n";
+        theme << "data: [";
+
+        std::string inner_comma = "";
+        for(auto& bucket : buckets){
+            theme << inner_comma << "[" << (bucket.low + bucket.high) / 2.0 << "," << 100.0 * bucket.count / total << "]";
+            inner_comma = ",";
+        }
+
+        theme << "]\n";
+        theme << "}\n";
+
+        comma = ",";
+    }
+
+    theme << "]\n";
+
+    end_graph(theme);
+    theme.after_graph();
+    ++id;
+}
+
+//Time under which a fraction of the samples fall, the x axis is 1 / (1 - p)
+//so that the tail percentiles (99%, 99.9%, ...) are equally spaced
+template<typename Theme>
+void generate_spectrum_graph(Theme& theme, std::size_t& id, const std::string& name, const std::vector<histogram_series>& series){
+    histogram_graph_start(theme, id, "Percentiles", name);
+
+    theme << "xAxis: { type: 'logarithmic', title: { text: 'Percentile' }, labels: { formatter: function(){ return (100 - 100 / this.value).toPrecision(4) + '%'; } } },\n";
+    theme << "yAxis: { title: { text: 'Time [ns]' }, min: 0 },\n";
+    theme << "tooltip: { formatter: function(){ return (100 - 100 / this.x).toPrecision(5) + '%: ' + this.y.toPrecision(4) + 'ns'; } },\n";
+
+    theme << "series: [\n";
+
+    std::string comma = "";
+    for(auto& s : series){
+        auto buckets = cpm::decode_histogram((*s.second)["histogram"].GetString());
+
+        uint64_t total = 0;
+        for(auto& bucket : buckets){
+            total += bucket.count;
+        }
+
+        theme << comma << "{\n";
+        theme << "name: '" << s.first << "',\n";
+        theme << "step: 'left',\n";
+        theme << "data: [";
+
+        uint64_t seen = 0;
+        std::string inner_comma = "";
+        for(auto& bucket : buckets){
+            seen += bucket.count;
+
+            //The last sample would be at infinity
+            double p = std::min(double(seen), total - 0.5) / total;
+
+            theme << inner_comma << "[" << 1.0 / (1.0 - p) << "," << bucket.high << "]";
+            inner_comma = ",";
+        }
+
+        theme << "]\n";
+        theme << "}\n";
+
+        comma = ",";
+    }
+
+    theme << "]\n";
+
+    end_graph(theme);
+    theme.after_graph();
+    ++id;
+}
+
+//Histograms of each size of the bench in the base document
+std::vector<histogram_series> size_histograms(json_value result){
+    std::vector<histogram_series> series;
+
+    for(auto& r : result["results"]){
+        if(r.HasMember("histogram")){
+            series.emplace_back(r["size"].GetString(), &r);
+        }
+    }
+
+    return series;
+}
+
+//Histograms of the largest size of the bench in the last runs and with the
+//other compilers, to compare the tails
+std::vector<histogram_series> run_histograms(json_value base_result, const cpm::document_t& base, const std::vector<cpm::document_cref>& documents, const std::vector<cpm::document_t>& all){
+    std::vector<const cpm::document_t*> selected;
+
+    //The history is limited to the last runs, the charts would be unreadable otherwise
+    const std::size_t history = 5;
+
+    for(std::size_t i = documents.size() > history ? documents.size() - history : 0; i < documents.size(); ++i){
+        selected.push_back(&static_cast<const cpm::document_t&>(documents[i]));
+    }
+
+    if(std::find(selected.begin(), selected.end(), &base) == selected.end()){
+        selected.push_back(&base);
+    }
+
+    for(auto& doc : all){
+        if(is_compiler_relevant(base, doc) && std::find(selected.begin(), selected.end(), &doc) == selected.end()){
+            selected.push_back(&doc);
+        }
+    }
+
+    std::vector<histogram_series> series;
+
+    for(auto* doc : selected){
+        for(auto& result : materialize(*doc)["results"]){
+            if(strip_equal(result["title"].GetString(), base_result["title"].GetString())){
+                auto& results = result["results"];
+
+                if(results.Size() && results[results.Size() - 1].HasMember("histogram")){
+                    series.emplace_back(std::string((*doc)["tag"].GetString()) + " (" + (*doc)["compiler"].GetString() + ")", &results[results.Size() - 1]);
+                }
+            }
+        }
+    }
+
+    return series;
+}
+
+//Histograms of the largest size of each implementation of the section
+std::vector<histogram_series> section_histograms(json_value section){
+    std::vector<histogram_series> series;
+
+    for(auto& r : section["results"]){
+        auto& results = r["results"];
+
+        if(results.Size() && results[results.Size() - 1].HasMember("histogram")){
+            series.emplace_back(r["name"].GetString(), &results[results.Size() - 1]);
+        }
+    }
+
+    return series;
+}
+
+template<typename Theme>
+std::pair<bool, double> find_same_duration(Theme& theme, const rapidjson::Value& base_result, const rapidjson::Value& r, const cpm::document_t& doc){
+    auto title = strip_tags(base_result["title"].GetString());
+
+    for(auto& p_r : index_of(doc).benches){
+        if(p_r.name == title){
+            for(std::size_t s = 0; s < p_r.sizes.size(); ++s){
+                if(p_r.sizes[s] == r["size"].GetString()){
+                    return std::make_pair(true, p_r.value(s, value_key_index(theme)) * normalization(theme, doc));
+                }
+            }
+        }
+    }
+
+    return std::make_pair(false, 0);
+}
+
+template<typename Theme>
+double add_compare_cell(Theme& theme, double current, double previous){
+    double diff = 0.0;
+
+    if(theme.options.count("mflops-graphs")){
+        if(previous == 0.0){
+            if(current < 0.0){
+                theme.red_cell(std::to_string(current) + "%");
+            } else if(current > 0.0){
+                theme.green_cell("+" + std::to_string(current) + "%");
+            } else {
+                theme.cell("+0%");
+            }
+        } else {
+            if(current < previous){
+                diff = -1.0 * (100.0 * (static_cast<double>(previous) / current) - 100.0);
+                theme.red_cell(std::to_string(diff) + "%");
+            } else if(current > previous){
+                diff = 1.0 * (100.0 * (static_cast<double>(current) / previous) - 100.0);
+                theme.green_cell("+" + std::to_string(diff) + "%");
+            } else {
+                theme.cell("+0%");
+            }
+        }
+    } else {
+        if(previous == 0.0){
+            if(current < 0.0){
+                theme.green_cell(std::to_string(current) + "%");
+            } else if(current > 0.0){
+                theme.red_cell("+" + std::to_string(current) + "%");
+            } else {
+                theme.cell("+0%");
+            }
+        } else {
+            if(current < previous){
+                diff = -1.0 * (100.0 * (static_cast<double>(previous) / current) - 100.0);
+                theme.green_cell(std::to_string(diff) + "%");
+            } else if(current > previous){
+                diff = 1.0 * (100.0 * (static_cast<double>(current) / previous) - 100.0);
+                theme.red_cell("+" + std::to_string(diff) + "%");
+            } else {
+                theme.cell("+0%");
+            }
         }
     }
 
@@ -480,13 +1991,13 @@ double add_compare_cell(Theme& theme, double current, double previous){
 }
 
 template<typename Theme>
-std::pair<bool,double> compare(Theme& theme, const rapidjson::Value& base_result, const rapidjson::Value& r, const cpm::document_t& doc){
+std::pair<bool,double> compare(Theme& theme, const rapidjson::Value& base_result, const rapidjson::Value& r, const cpm::document_t& base, const cpm::document_t& doc){
     bool found;
     int previous;
     std::tie(found, previous) = find_same_duration(theme, base_result, r, doc);
 
     if(found){
-        auto current = r[value_key_name(theme)].GetDouble();
+        auto current = statistic_value(theme, r) * normalization(theme, base);
 
         double diff = add_compare_cell(theme, current, previous);
         return std::make_pair(true, diff);
@@ -495,8 +2006,20 @@ std::pair<bool,double> compare(Theme& theme, const rapidjson::Value& base_result
     }
 }
 
+//Results too close to the clock resolution are flagged as unreliable
+template<typename Theme>
+void time_cell(Theme& theme, json_value r){
+    if(r.HasMember("unreliable") && r["unreliable"].GetBool()){
+        std::ostringstream value;
+        value << r["mean"].GetDouble() << " (unreliable)";
+        theme.cell(value.str());
+    } else {
+        theme << "<td>" << r["mean"].GetDouble() << "</td>\n";
+    }
+}
+
 template<typename Theme>
-void summary_header(Theme& theme){
+void summary_header(Theme& theme, bool counters, efficiency_columns efficiency){
     theme << "<tr>\n";
     theme << "<th>Size</th>\n";
     theme << "<th>Time</th>\n";
@@ -507,8 +2030,26 @@ void summary_header(Theme& theme){
         theme << "<th>Throughput [E/s]</th>\n";
     }
 
-    theme << "<th>Previous</th>\n";
-    theme << "<th>First</th>\n";
+    if(counters){
+        for(auto& counter : counter_columns){
+            theme << "<th>" << counter.second << "</th>\n";
+        }
+    }
+
+    if(efficiency.flops){
+        theme << "<th>Peak flops</th>\n";
+    }
+
+    if(efficiency.bandwidth){
+        theme << "<th>Peak bandwidth</th>\n";
+    }
+
+    if(has_baseline(theme)){
+        theme << "<th>Baseline (" << baseline_label(theme) << ")</th>\n";
+    } else {
+        theme << "<th>Previous</th>\n";
+        theme << "<th>First</th>\n";
+    }
 
     if(theme.data.compilers.size() > 1){
         theme << "<th>Best compiler</th>\n";
@@ -523,16 +2064,42 @@ void summary_header(Theme& theme){
     theme << "</tr>\n";
 }
 
+//Best fit of the sweep, at the end of the summary
+template<typename Theme>
+void complexity_row(Theme& theme, json_value value){
+    if(value.HasMember("complexity")){
+        theme << "<tr>\n";
+        theme.cell("Complexity");
+        theme.cell(value["complexity"].GetString());
+        theme.cell("coefficient: " + cpm::duration_str(value["complexity_coefficient"].GetDouble(), 3)
+            + ", rms: " + cpm::to_string_precision(100.0 * value["complexity_rms"].GetDouble(), 3) + "%");
+        theme << "</tr>\n";
+    }
+}
+
 template<typename Theme>
-void summary_footer(Theme& theme, double previous_acc, double first_acc){
+void summary_footer(Theme& theme, double previous_acc, double first_acc, bool counters, efficiency_columns efficiency){
     theme << "<tr>\n";
 
     theme << "<td>&nbsp;</td>\n";
     theme << "<td>&nbsp;</td>\n";
     theme << "<td>&nbsp;</td>\n";
 
+    if(counters){
+        for(std::size_t i = 0; i < counter_columns.size(); ++i){
+            theme << "<td>&nbsp;</td>\n";
+        }
+    }
+
+    for(std::size_t i = 0; i < std::size_t(efficiency.flops) + std::size_t(efficiency.bandwidth); ++i){
+        theme << "<td>&nbsp;</td>\n";
+    }
+
     add_compare_cell(theme, previous_acc, 0.0);
-    add_compare_cell(theme, first_acc, 0.0);
+
+    if(!has_baseline(theme)){
+        add_compare_cell(theme, first_acc, 0.0);
+    }
 
     if(theme.data.compilers.size() > 1){
         theme.cell("&nbsp;");
@@ -551,7 +2118,10 @@ template<typename Theme>
 void generate_summary_table(Theme& theme, const rapidjson::Value& base_result, const cpm::document_t& base){
     theme.before_summary();
 
-    summary_header(theme);
+    bool counters = counters_enabled(theme, base_result["results"]);
+    auto efficiency = efficiency_enabled(theme, base_result["results"], base);
+
+    summary_header(theme, counters, efficiency);
 
     double previous_acc = 0;
     double first_acc = 0;
@@ -562,7 +2132,7 @@ void generate_summary_table(Theme& theme, const rapidjson::Value& base_result, c
         theme << "<tr>\n";
 
         theme << "<td>" << r["size"].GetString() << "</td>\n";
-        theme << "<td>" << r["mean"].GetDouble() << "</td>\n";
+        time_cell(theme, r);
 
         if(flops){
             theme << "<td>" << cpm::throughput_str(r["throughput_f"].GetDouble()) << "</td>\n";
@@ -570,44 +2140,61 @@ void generate_summary_table(Theme& theme, const rapidjson::Value& base_result, c
             theme << "<td>" << cpm::throughput_str(r["throughput_e"].GetDouble()) << "</td>\n";
         }
 
+        if(counters){
+            counters_cells(theme, r);
+        }
+
+        efficiency_cells(theme, r, base, efficiency);
+
         bool previous_found = false;
         double diff = 0.0;
 
-        auto documents = select_documents(theme.data.documents, base);
+        if(has_baseline(theme)){
+            if(auto* baseline = find_baseline(theme, base)){
+                std::tie(previous_found, diff) = compare(theme, base_result, r, base, *baseline);
+                previous_acc += diff;
+            }
 
-        for(std::size_t i = 0; i < documents.size() - 1; ++i){
-            if(&static_cast<const cpm::document_t&>(documents[i+1]) == &base){
-                auto& doc = static_cast<const cpm::document_t&>(documents[i]);
-                std::tie(previous_found, diff) = compare(theme, base_result, r, doc);
+            if(!previous_found){
+                theme.cell("N/A");
+            }
+        } else {
+            auto documents = select_documents(theme.data.documents, base);
 
-                if(previous_found){
-                    previous_acc += diff;
-                    break;
+            for(std::size_t i = 0; i < documents.size() - 1; ++i){
+                if(&static_cast<const cpm::document_t&>(documents[i+1]) == &base){
+                    auto& doc = static_cast<const cpm::document_t&>(documents[i]);
+                    std::tie(previous_found, diff) = compare(theme, base_result, r, base, doc);
+
+                    if(previous_found){
+                        previous_acc += diff;
+                        break;
+                    }
                 }
             }
-        }
 
-        if(!previous_found){
-            theme.cell("N/A");
-        }
+            if(!previous_found){
+                theme.cell("N/A");
+            }
 
-        previous_found = false;
+            previous_found = false;
 
-        if(documents.size() > 1){
-            auto& doc = static_cast<const cpm::document_t&>(documents[0]);
-            std::tie(previous_found, diff) = compare(theme, base_result, r, doc);
+            if(documents.size() > 1){
+                auto& doc = static_cast<const cpm::document_t&>(documents[0]);
+                std::tie(previous_found, diff) = compare(theme, base_result, r, base, doc);
 
-            first_acc += diff;
-        }
+                first_acc += diff;
+            }
 
-        if(!previous_found){
-            theme.cell("N/A");
+            if(!previous_found){
+                theme.cell("N/A");
+            }
         }
 
         if(theme.data.compilers.size() > 1){
             std::string best_compiler = base["compiler"].GetString();
-            auto best = r[value_key_name(theme)].GetDouble();
-            auto worst = r[value_key_name(theme)].GetDouble();
+            auto best = statistic_value(theme, r) * normalization(theme, base);
+            auto worst = statistic_value(theme, r) * normalization(theme, base);
 
             for(auto& doc : theme.data.documents){
                 if(is_compiler_relevant(base, doc)){
@@ -644,8 +2231,8 @@ void generate_summary_table(Theme& theme, const rapidjson::Value& base_result, c
 
         if(theme.data.configurations.size() > 1){
             std::string best_configuration = base["configuration"].GetString();
-            auto best = r[value_key_name(theme)].GetDouble();
-            auto worst = r[value_key_name(theme)].GetDouble();
+            auto best = statistic_value(theme, r) * normalization(theme, base);
+            auto worst = statistic_value(theme, r) * normalization(theme, base);
 
             for(auto& doc : theme.data.documents){
                 if(is_configuration_relevant(base, doc)){
@@ -686,82 +2273,283 @@ void generate_summary_table(Theme& theme, const rapidjson::Value& base_result, c
     previous_acc /= base_result["results"].Size();
     first_acc /= base_result["results"].Size();
 
-    summary_footer(theme, previous_acc, first_acc);
+    summary_footer(theme, previous_acc, first_acc, counters, efficiency);
+    complexity_row(theme, base_result);
 
     theme.after_summary();
 }
 
+//Value of a measure in each run of the history
+struct history_point {
+    const cpm::document_t* doc;
+    double value;
+};
+
+//History of a size of the bench, of its largest size if size is null
 template<typename Theme>
-void generate_time_graph(Theme& theme, std::size_t& id, const rapidjson::Value& result, const std::vector<cpm::document_cref>& documents){
-    theme.before_graph(id);
+std::vector<history_point> bench_history(Theme& theme, json_value result, const char* size, const std::vector<cpm::document_cref>& documents){
+    std::vector<history_point> history;
 
-    std::string graph_title = "Time" +
-        (theme.options.count("pages") ? std::string() : std::string(": ") + strip_tags(result["title"].GetString()));
-    start_graph(theme, std::string("chart_") + std::to_string(id), graph_title);
+    auto title = strip_tags(result["title"].GetString());
+    auto key = value_key_index(theme);
 
-    theme << "xAxis: { type: 'datetime', title: { text: 'Date' } },\n";
+    for(auto& document_r : documents){
+        auto& document = static_cast<const cpm::document_t&>(document_r);
 
-    y_axis_configuration(theme);
+        for(auto& o_result : index_of(document).benches){
+            if(o_result.name == title && !o_result.sizes.empty()){
+                if(!size){
+                    history.push_back({&document, o_result.value(o_result.sizes.size() - 1, key) * normalization(theme, document)});
+                    continue;
+                }
 
-    if(!theme.options.count("time-sizes")){
-        theme << "legend: { enabled: false },\n";
+                for(std::size_t s = 0; s < o_result.sizes.size(); ++s){
+                    if(o_result.sizes[s] == size){
+                        history.push_back({&document, o_result.value(s, key) * normalization(theme, document)});
+                    }
+                }
+            }
+        }
     }
 
-    theme << "series: [\n";
-
-    if(theme.options.count("time-sizes")){
-        std::string comma = "";
-        for(auto& r : result["results"]){
-            theme << comma << "{\n";
-
-            theme << "name: '" << r["size"].GetString() << "',\n";
-            theme << "data: [";
-
-            std::string inner_comma = "";
+    return history;
+}
 
-            for(auto& document_r : documents){
-                auto& document = static_cast<const cpm::document_t&>(document_r);
+//History of a size of an implementation of the section, of its largest size
+//if size is null
+template<typename Theme>
+std::vector<history_point> section_history(Theme& theme, json_value section, json_value implementation, const char* size, const std::vector<cpm::document_cref>& documents){
+    std::vector<history_point> history;
+
+    auto name = strip_tags(section["name"].GetString());
+    auto implementation_name = strip_tags(implementation["name"].GetString());
+    auto key = value_key_index(theme);
+
+    for(auto& r_doc_r : documents){
+        auto& r_doc = static_cast<const cpm::document_t&>(r_doc_r);
+
+        for(auto& r_section : index_of(r_doc).sections){
+            if(r_section.name == name){
+                for(auto& r_r : r_section.implementations){
+                    if(r_r.name == implementation_name && !r_r.sizes.empty()){
+                        if(!size){
+                            history.push_back({&r_doc, r_r.value(r_r.sizes.size() - 1, key) * normalization(theme, r_doc)});
+                            continue;
+                        }
 
-                for(auto& o_result : document["results"]){
-                    if(strip_equal(o_result["title"].GetString(), result["title"].GetString())){
-                        for(auto& o_rr : o_result["results"]){
-                            if(o_rr["size"].GetString() == r["size"].GetString()){
-                                theme << inner_comma << "[" << size_t(document["timestamp"].GetInt()) * 1000 << ",";
-                                theme << o_rr[value_key_name(theme)].GetDouble() << "]";
-                                inner_comma = ",";
+                        for(std::size_t s = 0; s < r_r.sizes.size(); ++s){
+                            if(r_r.sizes[s] == size){
+                                history.push_back({&r_doc, r_r.value(s, key) * normalization(theme, r_doc)});
                             }
                         }
                     }
                 }
             }
+        }
+    }
 
-            theme << "]\n";
-            theme << "}\n";
-            comma =",";
+    return history;
+}
+
+//Fitted complexity of a bench or of an implementation in a run
+struct complexity_point {
+    const cpm::document_t* doc;
+    std::string complexity;
+};
+
+std::vector<complexity_point> bench_complexities(json_value result, const std::vector<cpm::document_cref>& documents){
+    std::vector<complexity_point> history;
+
+    auto title = strip_tags(result["title"].GetString());
+
+    for(auto& document_r : documents){
+        auto& document = static_cast<const cpm::document_t&>(document_r);
+
+        for(auto& o_result : index_of(document).benches){
+            if(o_result.name == title && !o_result.complexity.empty()){
+                history.push_back({&document, o_result.complexity});
+            }
         }
-    } else {
-        theme << "{\n";
+    }
 
-        theme << "name: '',\n";
-        theme << "data: [";
+    return history;
+}
 
-        std::string comma = "";
+std::vector<complexity_point> section_complexities(json_value section, json_value implementation, const std::vector<cpm::document_cref>& documents){
+    std::vector<complexity_point> history;
 
-        for(auto& document_r : documents){
-            auto& document = static_cast<const cpm::document_t&>(document_r);
+    auto name = strip_tags(section["name"].GetString());
+    auto implementation_name = strip_tags(implementation["name"].GetString());
 
-            for(auto& o_result : document["results"]){
-                if(strip_equal(o_result["title"].GetString(), result["title"].GetString())){
-                    theme << comma << "[" << size_t(document["timestamp"].GetInt()) * 1000 << ",";
-                    auto& o_r_results = o_result["results"];
-                    theme << o_r_results[o_r_results.Size() - 1][value_key_name(theme)].GetDouble() << "]";
-                    comma = ",";
+    for(auto& r_doc_r : documents){
+        auto& r_doc = static_cast<const cpm::document_t&>(r_doc_r);
+
+        for(auto& r_section : index_of(r_doc).sections){
+            if(r_section.name == name){
+                for(auto& r_r : r_section.implementations){
+                    if(r_r.name == implementation_name && !r_r.complexity.empty()){
+                        history.push_back({&r_doc, r_r.complexity});
+                    }
                 }
             }
         }
+    }
+
+    return history;
+}
+
+//Indices of the runs whose complexity differs from the previous run
+std::vector<std::size_t> complexity_changes(const std::vector<complexity_point>& history){
+    std::vector<std::size_t> changes;
+
+    for(std::size_t i = 1; i < history.size(); ++i){
+        if(history[i].complexity != history[i - 1].complexity){
+            changes.push_back(i);
+        }
+    }
 
-        theme << "]\n";
+    return changes;
+}
+
+//Vertical line at the first run of each new complexity, name is the series
+template<typename Theme>
+void complexity_lines(Theme& theme, std::string& comma, const std::string& name, const std::vector<complexity_point>& history){
+    for(auto index : complexity_changes(history)){
+        auto& doc = *history[index].doc;
+
+        std::string label = (name.empty() ? std::string() : name + ": ") + doc["tag"].GetString() + " " + history[index - 1].complexity + " -> " + history[index].complexity;
+
+        theme << comma << "{ value: " << size_t(doc["timestamp"].GetInt()) * 1000
+            << ", color: '#f0ad4e', dashStyle: 'Dot', width: 2, zIndex: 3"
+            << ", label: { text: '" << std::regex_replace(label, std::regex("'"), "\\'") << "', rotation: 90, style: { color: '#AAAAAA' } } }";
+
+        comma = ",";
+    }
+}
+
+template<typename Theme>
+std::vector<cpm::change_point> history_changes(Theme& theme, const std::vector<history_point>& history){
+    if(!changes_enabled(theme)){
+        return {};
+    }
+
+    std::vector<double> values;
+    for(auto& point : history){
+        values.push_back(point.value);
+    }
+
+    return cpm::change_points(values, theme.options["change-threshold"].template as<double>() / 100.0);
+}
+
+//The graphs show either a time or a throughput
+template<typename Theme>
+bool is_slowdown(Theme& theme, const cpm::change_point& change){
+    return theme.options.count("mflops-graphs") ? change.after < change.before : change.after > change.before;
+}
+
+std::string relative_change_str(const cpm::change_point& change){
+    double percent = 100.0 * (change.after / change.before - 1.0);
+    return (percent > 0.0 ? "+" : "") + cpm::to_string_precision(percent, 3) + "%";
+}
+
+template<typename Theme>
+std::string history_value_str(Theme& theme, double value){
+    return theme.options.count("mflops-graphs") ? cpm::throughput_str(value, 3) + "Flop/s" : cpm::duration_str(value, 3);
+}
+
+//Series of the history of the implementations of a section, one per size of
+//each implementation with --time-sizes
+template<typename Theme>
+std::vector<std::pair<std::string, std::vector<history_point>>> section_series(Theme& theme, json_value section, json_value implementation, const std::vector<cpm::document_cref>& documents){
+    std::vector<std::pair<std::string, std::vector<history_point>>> series;
+
+    auto name = strip_tags(implementation["name"].GetString());
+
+    if(theme.options.count("time-sizes")){
+        for(auto& r : implementation["results"]){
+            series.emplace_back(name + " (" + r["size"].GetString() + ")", section_history(theme, section, implementation, r["size"].GetString(), documents));
+        }
+    } else {
+        series.emplace_back(name, section_history(theme, section, implementation, nullptr, documents));
+    }
+
+    return series;
+}
+
+//Vertical line at the first run after each change, name is the series
+template<typename Theme>
+void change_lines(Theme& theme, std::string& comma, const std::string& name, const std::vector<history_point>& history, const std::vector<cpm::change_point>& changes){
+    for(auto& change : changes){
+        auto& doc = *history[change.index].doc;
+
+        std::string label = (name.empty() ? std::string() : name + ": ") + doc["tag"].GetString() + " " + relative_change_str(change);
+
+        theme << comma << "{ value: " << size_t(doc["timestamp"].GetInt()) * 1000
+            << ", color: '" << (is_slowdown(theme, change) ? "#d9534f" : "#5cb85c") << "', dashStyle: 'Dash', width: 2, zIndex: 3"
+            << ", label: { text: '" << std::regex_replace(label, std::regex("'"), "\\'") << "', rotation: 90, style: { color: '#AAAAAA' } } }";
+
+        comma = ",";
+    }
+}
+
+template<typename Theme>
+void history_data(Theme& theme, const std::vector<history_point>& history){
+    theme << "data: [";
+
+    std::string comma = "";
+
+    for(auto& point : history){
+        theme << comma << "[" << size_t((*point.doc)["timestamp"].GetInt()) * 1000 << "," << point.value << "]";
+        comma = ",";
+    }
+
+    theme << "]\n";
+}
+
+template<typename Theme>
+void generate_time_graph(Theme& theme, std::size_t& id, const rapidjson::Value& result, const std::vector<cpm::document_cref>& documents){
+    theme.before_graph(id);
+
+    std::string graph_title = "Time" +
+        (theme.options.count("pages") ? std::string() : std::string(": ") + strip_tags(result["title"].GetString()));
+    start_graph(theme, std::string("chart_") + std::to_string(id), graph_title);
+
+    std::vector<std::pair<std::string, std::vector<history_point>>> series;
+
+    if(theme.options.count("time-sizes")){
+        for(auto& r : result["results"]){
+            series.emplace_back(r["size"].GetString(), bench_history(theme, result, r["size"].GetString(), documents));
+        }
+    } else {
+        series.emplace_back("", bench_history(theme, result, nullptr, documents));
+    }
+
+    theme << "xAxis: { type: 'datetime', title: { text: 'Date' }, plotLines: [";
+
+    std::string lines_comma = "";
+    for(auto& s : series){
+        change_lines(theme, lines_comma, s.first, s.second, history_changes(theme, s.second));
+    }
+
+    complexity_lines(theme, lines_comma, "", bench_complexities(result, documents));
+
+    theme << "] },\n";
+
+    y_axis_configuration(theme);
+
+    if(!theme.options.count("time-sizes")){
+        theme << "legend: { enabled: false },\n";
+    }
+
+    theme << "series: [\n";
+
+    std::string comma = "";
+    for(auto& s : series){
+        theme << comma << "{\n";
+        theme << "name: '" << s.first << "',\n";
+        history_data(theme, s.second);
         theme << "}\n";
+        comma = ",";
     }
 
     theme << "]\n";
@@ -785,26 +2573,170 @@ std::vector<std::string> gather_sizes(const rapidjson::Value& section){
         }
     }
 
-    return sizes;
+    return sizes;
+}
+
+template<typename Theme>
+void generate_section_run_graph(Theme& theme, std::size_t& id, const rapidjson::Value& section, const cpm::document_t& doc){
+    theme.before_graph(id);
+
+    std::string graph_title = "Last run" +
+        (theme.options.count("pages") ? std::string() : std::string(": ") + strip_tags(section["name"].GetString()));
+    start_graph(theme, std::string("chart_") + std::to_string(id), graph_title);
+
+    theme << "xAxis: { categories: \n";
+
+    auto sizes = gather_sizes(section);
+
+    json_array_string(theme, sizes);
+
+    theme << "},\n";
+
+    y_axis_configuration(theme);
+
+    theme << "legend: { align: 'left', verticalAlign: 'top', floating: false, borderWidth: 0, y: 20 },\n";
+
+    theme << "series: [\n";
+
+    std::string comma = "";
+    for(auto& r : section["results"]){
+        theme << comma << "{\n";
+
+        theme << "name: '" << strip_tags(r["name"].GetString()) << "',\n";
+        theme << "data: ";
+
+        json_array_value(theme, statistic_collect(theme, r["results"]));
+
+        theme << "\n}\n";
+        comma = ",";
+    }
+
+    if(auto* baseline = find_baseline(theme, doc)){
+        for(auto& o_section : (*baseline)["sections"]){
+            if(strip_equal(o_section["name"].GetString(), section["name"].GetString())){
+                for(auto& o_r : o_section["results"]){
+                    generate_baseline_series(theme, comma, sizes, o_r["results"], strip_tags(o_r["name"].GetString()));
+                }
+            }
+        }
+    }
+
+    theme << "]\n";
+
+    end_graph(theme);
+    theme.after_graph();
+    ++id;
+}
+
+template<typename Theme>
+void generate_section_time_graph(Theme& theme, std::size_t& id, const rapidjson::Value& section, const std::vector<cpm::document_cref>& documents){
+    theme.before_graph(id);
+
+    std::string graph_title = "Time" +
+        (theme.options.count("pages") ? std::string() : std::string(": ") + strip_tags(section["name"].GetString()));
+    start_graph(theme, std::string("chart_") + std::to_string(id), graph_title);
+
+    std::vector<std::pair<std::string, std::vector<history_point>>> series;
+
+    for(auto& r : section["results"]){
+        for(auto& s : section_series(theme, section, r, documents)){
+            series.push_back(std::move(s));
+        }
+    }
+
+    theme << "xAxis: { type: 'datetime', title: { text: 'Date' }, plotLines: [";
+
+    std::string lines_comma = "";
+    for(auto& s : series){
+        change_lines(theme, lines_comma, s.first, s.second, history_changes(theme, s.second));
+    }
+
+    for(auto& r : section["results"]){
+        complexity_lines(theme, lines_comma, strip_tags(r["name"].GetString()), section_complexities(section, r, documents));
+    }
+
+    theme << "] },\n";
+
+    y_axis_configuration(theme);
+
+    theme << "legend: { align: 'left', verticalAlign: 'top', floating: false, borderWidth: 0, y: 20 },\n";
+
+    theme << "series: [\n";
+
+    std::string comma = "";
+    for(auto& s : series){
+        theme << comma << "{\n";
+        theme << "name: '" << s.first << "',\n";
+        history_data(theme, s.second);
+        theme << "}\n";
+        comma = ",";
+    }
+
+    theme << "]\n";
+
+    end_graph(theme);
+    theme.after_graph();
+    ++id;
+}
+
+template<typename Theme>
+void generate_section_counters_graph(Theme& theme, std::size_t& id, const rapidjson::Value& section){
+    theme.before_graph(id);
+
+    std::string graph_title = "IPC" +
+        (theme.options.count("pages") ? std::string() : std::string(": ") + strip_tags(section["name"].GetString()));
+    start_graph(theme, std::string("chart_") + std::to_string(id), graph_title);
+
+    theme << "xAxis: { categories: \n";
+
+    json_array_string(theme, gather_sizes(section));
+
+    theme << "},\n";
+
+    theme << "yAxis: { title: { text: 'Instructions per cycle' }, min: 0 },\n";
+
+    theme << "legend: { align: 'left', verticalAlign: 'top', floating: false, borderWidth: 0, y: 20 },\n";
+
+    theme << "series: [\n";
+
+    std::string comma = "";
+    for(auto& r : section["results"]){
+        theme << comma << "{\n";
+
+        theme << "name: '" << strip_tags(r["name"].GetString()) << "',\n";
+        theme << "data: ";
+
+        json_array_value(theme, optional_collect(r["results"], "ipc"));
+
+        theme << "\n}\n";
+        comma = ",";
+    }
+
+    theme << "]\n";
+
+    end_graph(theme);
+    theme.after_graph();
+    ++id;
 }
 
 template<typename Theme>
-void generate_section_run_graph(Theme& theme, std::size_t& id, const rapidjson::Value& section){
+void generate_section_resources_graph(Theme& theme, std::size_t& id, const rapidjson::Value& section){
     theme.before_graph(id);
 
-    std::string graph_title = "Last run" +
+    std::string graph_title = "Resources" +
         (theme.options.count("pages") ? std::string() : std::string(": ") + strip_tags(section["name"].GetString()));
     start_graph(theme, std::string("chart_") + std::to_string(id), graph_title);
 
     theme << "xAxis: { categories: \n";
 
-    auto sizes = gather_sizes(section);
-
-    json_array_string(theme, sizes);
+    json_array_string(theme, gather_sizes(section));
 
     theme << "},\n";
 
-    y_axis_configuration(theme);
+    theme << "yAxis: [\n";
+    theme << "{ title: { text: 'Page faults' }, min: 0 },\n";
+    theme << "{ title: { text: 'Context switches' }, min: 0, opposite: true }\n";
+    theme << "],\n";
 
     theme << "legend: { align: 'left', verticalAlign: 'top', floating: false, borderWidth: 0, y: 20 },\n";
 
@@ -814,10 +2746,19 @@ void generate_section_run_graph(Theme& theme, std::size_t& id, const rapidjson::
     for(auto& r : section["results"]){
         theme << comma << "{\n";
 
-        theme << "name: '" << strip_tags(r["name"].GetString()) << "',\n";
+        theme << "name: '" << strip_tags(r["name"].GetString()) << " faults',\n";
+        theme << "data: ";
+
+        json_array_value(theme, sum_collect(r["results"], {"minor_faults", "major_faults"}));
+
+        theme << "\n},{\n";
+
+        theme << "name: '" << strip_tags(r["name"].GetString()) << " switches',\n";
+        theme << "yAxis: 1,\n";
+        theme << "dashStyle: 'ShortDash',\n";
         theme << "data: ";
 
-        json_array_value(theme, double_collect(r["results"], value_key_name(theme)));
+        json_array_value(theme, sum_collect(r["results"], {"voluntary_switches", "involuntary_switches"}));
 
         theme << "\n}\n";
         comma = ",";
@@ -830,51 +2771,64 @@ void generate_section_run_graph(Theme& theme, std::size_t& id, const rapidjson::
     ++id;
 }
 
+bool section_has_threads(json_value section){
+    for(auto& r : section["results"]){
+        if(has_member(r["results"], "threads")){
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//Replaces the run graph for the sections of parallel measures
 template<typename Theme>
-void generate_section_time_graph(Theme& theme, std::size_t& id, const rapidjson::Value& section, const std::vector<cpm::document_cref>& documents){
+void generate_section_scaling_graph(Theme& theme, std::size_t& id, const rapidjson::Value& section){
     theme.before_graph(id);
 
-    std::string graph_title = "Time" +
+    std::string graph_title = "Scaling" +
         (theme.options.count("pages") ? std::string() : std::string(": ") + strip_tags(section["name"].GetString()));
     start_graph(theme, std::string("chart_") + std::to_string(id), graph_title);
 
-    theme << "xAxis: { type: 'datetime', title: { text: 'Date' } },\n";
+    std::vector<std::string> threads;
+    std::vector<std::string> ideal;
 
-    y_axis_configuration(theme);
+    for(auto& r : section["results"]){
+        if(r["results"].Size() > threads.size()){
+            auto scaling = compute_scaling(r["results"]);
+            threads = scaling.threads;
+            ideal = scaling.ideal;
+        }
+    }
 
-    theme << "legend: { align: 'left', verticalAlign: 'top', floating: false, borderWidth: 0, y: 20 },\n";
+    scaling_axis_configuration(theme, threads);
 
     theme << "series: [\n";
 
-    std::string comma = "";
-    for(auto& r : section["results"]){
-        theme << comma << "{\n";
-
-        theme << "name: '" << strip_tags(r["name"].GetString()) << "',\n";
-        theme << "data: [";
-
-        std::string comma_inner = "";
+    theme << "{\n";
+    theme << "name: 'Ideal',\n";
+    theme << "dashStyle: 'dot',\n";
+    theme << "data: ";
+    json_array_value(theme, ideal);
+    theme << "\n}\n";
 
-        for(auto& r_doc_r : documents){
-            auto& r_doc = static_cast<const cpm::document_t&>(r_doc_r);
+    for(auto& r : section["results"]){
+        auto scaling = compute_scaling(r["results"]);
+        auto name = strip_tags(r["name"].GetString());
 
-            for(auto& r_section : r_doc["sections"]){
-                if(strip_equal(r_section["name"].GetString(), section["name"].GetString())){
-                    for(auto& r_r : r_section["results"]){
-                        if(strip_equal(r_r["name"].GetString(), r["name"].GetString())){
-                            theme << comma_inner << "[" << size_t(r_doc["timestamp"].GetInt()) * 1000 << ",";
-                            auto& r_r_results = r_r["results"];
-                            theme << r_r_results[r_r_results.Size() - 1][value_key_name(theme)].GetDouble() << "]";
-                            comma_inner = ",";
-                        }
-                    }
-                }
-            }
-        }
+        theme << ",{\n";
+        theme << "name: '" << name << "',\n";
+        theme << "data: ";
+        json_array_value(theme, scaling.speedup);
+        theme << "\n}\n";
 
-        theme << "]\n";
-        theme << "}\n";
-        comma = ",";
+        theme << ",{\n";
+        theme << "name: '" << name << " efficiency',\n";
+        theme << "yAxis: 1,\n";
+        theme << "dashStyle: 'dash',\n";
+        theme << "data: ";
+        json_array_value(theme, scaling.efficiency);
+        theme << "\n}\n";
     }
 
     theme << "]\n";
@@ -914,7 +2868,7 @@ void generate_section_compare_graph(Theme& theme, std::size_t& id, const rapidjs
         std::string comma = "";
         for(auto& document : theme.data.documents){
             if(f(document)){
-                for(auto& o_section : document["sections"]){
+                for(auto& o_section : materialize(document)["sections"]){
                     if(strip_equal(o_section["name"].GetString(), section["name"].GetString())){
                         for(auto& o_r : o_section["results"]){
                             if(strip_equal(o_r["name"].GetString(), r["name"].GetString())){
@@ -922,7 +2876,7 @@ void generate_section_compare_graph(Theme& theme, std::size_t& id, const rapidjs
                                 theme << "name: '" << document[attr].GetString() << "',\n";
                                 theme << "data: ";
 
-                                json_array_value(theme, double_collect(o_r["results"], value_key_name(theme)));
+                                json_array_value(theme, statistic_collect(theme, o_r["results"]));
 
                                 theme << "\n}\n";
 
@@ -931,6 +2885,18 @@ void generate_section_compare_graph(Theme& theme, std::size_t& id, const rapidjs
                         }
                     }
                 }
+
+                if(auto* baseline = find_baseline(theme, document)){
+                    for(auto& o_section : (*baseline)["sections"]){
+                        if(strip_equal(o_section["name"].GetString(), section["name"].GetString())){
+                            for(auto& o_r : o_section["results"]){
+                                if(strip_equal(o_r["name"].GetString(), r["name"].GetString())){
+                                    generate_baseline_series(theme, comma, sizes, o_r["results"], document[attr].GetString());
+                                }
+                            }
+                        }
+                    }
+                }
             }
         }
 
@@ -958,13 +2924,16 @@ void generate_section_configuration_graph(Theme& theme, std::size_t& id, const r
 
 template<typename Theme>
 std::pair<bool, double> find_same_duration_section(Theme& theme, json_value base_result, json_value base_section, json_value r, const cpm::document_t& doc){
-    for(auto& section : doc["sections"]){
-        if(strip_equal(section["name"].GetString(), base_section["name"].GetString())){
-            for(auto& result : section["results"]){
-                if(strip_equal(result["name"].GetString(), base_result["name"].GetString())){
-                    for(auto& p_r_r : result["results"]){
-                        if(str_equal(p_r_r["size"].GetString(), r["size"].GetString())){
-                            return std::make_pair(true, p_r_r[value_key_name(theme)].GetDouble());
+    auto name = strip_tags(base_section["name"].GetString());
+    auto implementation = strip_tags(base_result["name"].GetString());
+
+    for(auto& section : index_of(doc).sections){
+        if(section.name == name){
+            for(auto& result : section.implementations){
+                if(result.name == implementation){
+                    for(std::size_t s = 0; s < result.sizes.size(); ++s){
+                        if(result.sizes[s] == r["size"].GetString()){
+                            return std::make_pair(true, result.value(s, value_key_index(theme)) * normalization(theme, doc));
                         }
                     }
                 }
@@ -976,13 +2945,13 @@ std::pair<bool, double> find_same_duration_section(Theme& theme, json_value base
 }
 
 template<typename Theme>
-std::pair<bool,double> compare_section(Theme& theme, json_value base_result, json_value base_section, json_value r, const cpm::document_t& doc){
+std::pair<bool,double> compare_section(Theme& theme, json_value base_result, json_value base_section, json_value r, const cpm::document_t& base, const cpm::document_t& doc){
     bool found;
     int previous;
     std::tie(found, previous) = find_same_duration_section(theme, base_result, base_section, r, doc);
 
     if(found){
-        auto current = r[value_key_name(theme)].GetDouble();
+        auto current = statistic_value(theme, r) * normalization(theme, base);
 
         double diff = add_compare_cell(theme, current, previous);
         return std::make_pair(true, diff);
@@ -1001,7 +2970,10 @@ void generate_section_summary_table(Theme& theme, std::size_t id, json_value bas
     for(auto& base_result : base_section["results"]){
         theme.before_sub_summary(id * 1000000, sub_id++);
 
-        summary_header(theme);
+        bool counters = counters_enabled(theme, base_result["results"]);
+        auto efficiency = efficiency_enabled(theme, base_result["results"], base);
+
+        summary_header(theme, counters, efficiency);
 
         double previous_acc = 0;
         double first_acc = 0;
@@ -1009,7 +2981,7 @@ void generate_section_summary_table(Theme& theme, std::size_t id, json_value bas
         for(auto& r : base_result["results"]){
             theme << "<tr>\n";
             theme << "<td>" << r["size"].GetString() << "</td>\n";
-            theme << "<td>" << r["mean"].GetDouble() << "</td>\n";
+            time_cell(theme, r);
 
             if(flops){
                 theme << "<td>" << cpm::throughput_str(r["throughput_f"].GetDouble()) << "</td>\n";
@@ -1017,44 +2989,61 @@ void generate_section_summary_table(Theme& theme, std::size_t id, json_value bas
                 theme << "<td>" << cpm::throughput_str(r["throughput_e"].GetDouble()) << "</td>\n";
             }
 
+            if(counters){
+                counters_cells(theme, r);
+            }
+
+            efficiency_cells(theme, r, base, efficiency);
+
             bool previous_found = false;
             double diff = 0.0;
 
-            auto documents = select_documents(theme.data.documents, base);
+            if(has_baseline(theme)){
+                if(auto* baseline = find_baseline(theme, base)){
+                    std::tie(previous_found, diff) = compare_section(theme, base_result, base_section, r, base, *baseline);
+                    previous_acc += diff;
+                }
 
-            for(std::size_t i = 0; i < documents.size() - 1; ++i){
-                if(&static_cast<const cpm::document_t&>(documents[i+1]) == &base){
-                    auto& doc = static_cast<const cpm::document_t&>(documents[i]);
-                    std::tie(previous_found, diff) = compare_section(theme, base_result, base_section, r, doc);
+                if(!previous_found){
+                    theme << "<td>N/A</td>\n";
+                }
+            } else {
+                auto documents = select_documents(theme.data.documents, base);
 
-                    if(previous_found){
-                        previous_acc += diff;
-                        break;
+                for(std::size_t i = 0; i < documents.size() - 1; ++i){
+                    if(&static_cast<const cpm::document_t&>(documents[i+1]) == &base){
+                        auto& doc = static_cast<const cpm::document_t&>(documents[i]);
+                        std::tie(previous_found, diff) = compare_section(theme, base_result, base_section, r, base, doc);
+
+                        if(previous_found){
+                            previous_acc += diff;
+                            break;
+                        }
                     }
                 }
-            }
 
-            if(!previous_found){
-                theme << "<td>N/A</td>\n";
-            }
+                if(!previous_found){
+                    theme << "<td>N/A</td>\n";
+                }
 
-            previous_found = false;
+                previous_found = false;
 
-            if(documents.size() > 1){
-                auto& doc = static_cast<const cpm::document_t&>(documents[0]);
-                std::tie(previous_found, diff) = compare_section(theme, base_result, base_section, r, doc);
+                if(documents.size() > 1){
+                    auto& doc = static_cast<const cpm::document_t&>(documents[0]);
+                    std::tie(previous_found, diff) = compare_section(theme, base_result, base_section, r, base, doc);
 
-                first_acc += diff;
-            }
+                    first_acc += diff;
+                }
 
-            if(!previous_found){
-                theme << "<td>N/A</td>\n";
+                if(!previous_found){
+                    theme << "<td>N/A</td>\n";
+                }
             }
 
             if(theme.data.compilers.size() > 1){
                 std::string best_compiler = base["compiler"].GetString();
-                auto best = r[value_key_name(theme)].GetDouble();
-                auto worst = r[value_key_name(theme)].GetDouble();
+                auto best = statistic_value(theme, r) * normalization(theme, base);
+                auto worst = statistic_value(theme, r) * normalization(theme, base);
 
                 for(auto& doc : theme.data.documents){
                     if(is_compiler_relevant(base, doc)){
@@ -1091,8 +3080,8 @@ void generate_section_summary_table(Theme& theme, std::size_t id, json_value bas
 
             if(theme.data.configurations.size() > 1){
                 std::string best_configuration = base["configuration"].GetString();
-                auto best = r[value_key_name(theme)].GetDouble();
-                auto worst = r[value_key_name(theme)].GetDouble();
+                auto best = statistic_value(theme, r) * normalization(theme, base);
+                auto worst = statistic_value(theme, r) * normalization(theme, base);
 
                 for(auto& doc : theme.data.documents){
                     if(is_configuration_relevant(base, doc)){
@@ -1133,7 +3122,8 @@ void generate_section_summary_table(Theme& theme, std::size_t id, json_value bas
         previous_acc /= base_result["results"].Size();
         first_acc /= base_result["results"].Size();
 
-        summary_footer(theme, previous_acc, first_acc);
+        summary_footer(theme, previous_acc, first_acc, counters, efficiency);
+        complexity_row(theme, base_result);
 
         theme.after_sub_summary();
     }
@@ -1141,8 +3131,157 @@ void generate_section_summary_table(Theme& theme, std::size_t id, json_value bas
     theme.after_sub_graphs();
 }
 
+//Raw samples of a document, mapped the first time they are needed
+template<typename Theme>
+const cpm::sample_file* document_samples(Theme& theme, const cpm::document_t& doc){
+    static std::map<std::string, std::unique_ptr<cpm::sample_file>> files;
+
+    if(!doc.HasMember("samples_file")){
+        return nullptr;
+    }
+
+    auto file = theme.options["input"].template as<std::string>() + "/" + doc["samples_file"].GetString();
+
+    auto it = files.find(file);
+
+    if(it == files.end()){
+        auto samples = std::make_unique<cpm::sample_file>();
+
+        if(!samples->open(file)){
+            std::cout << "Impossible to read the raw samples " << file << std::endl;
+            samples.reset();
+        }
+
+        it = files.emplace(file, std::move(samples)).first;
+    }
+
+    return it->second.get();
+}
+
+//Raw samples to chart and their name in the legend
+struct samples_series {
+    std::string name;
+    const cpm::sample_record* records;
+    std::size_t count;
+};
+
+//Raw samples of each size of the bench
+std::vector<samples_series> size_samples(const cpm::sample_file* file, json_value result){
+    std::vector<samples_series> series;
+
+    if(file){
+        for(auto& r : result["results"]){
+            auto i = file->find(result["title"].GetString(), "", r["size"].GetString());
+
+            if(i < file->series() && file->count(i)){
+                series.push_back({r["size"].GetString(), file->samples(i), file->count(i)});
+            }
+        }
+    }
+
+    return series;
+}
+
+//Raw samples of the largest size of each implementation of the section
+std::vector<samples_series> section_samples(const cpm::sample_file* file, json_value section){
+    std::vector<samples_series> series;
+
+    if(file){
+        for(auto& r : section["results"]){
+            auto& results = r["results"];
+
+            if(!results.Size()){
+                continue;
+            }
+
+            auto i = file->find(section["name"].GetString(), r["name"].GetString(), results[results.Size() - 1]["size"].GetString());
+
+            if(i < file->series() && file->count(i)){
+                series.push_back({r["name"].GetString(), file->samples(i), file->count(i)});
+            }
+        }
+    }
+
+    return series;
+}
+
+//Duration of each sample along the run, to spot drifts and hiccups. Long
+//series are reduced to the lowest and the highest sample of each block
+template<typename Theme>
+void generate_samples_graph(Theme& theme, std::size_t& id, const std::string& name, const std::vector<samples_series>& series){
+    const std::size_t blocks = 1000;
+
+    //The parallel measures do not have the time of the samples
+    bool timed = true;
+    for(auto& s : series){
+        timed = timed && s.records[s.count - 1].time > 0.0;
+    }
+
+    theme.before_graph(id);
+
+    std::string title = std::string("Samples") +
+        (theme.options.count("pages") ? std::string() : std::string(": ") + strip_tags(name));
+
+    start_graph(theme, std::string("chart_") + std::to_string(id), title);
+
+    theme << "chart: { type: 'scatter', zoomType: 'xy' },\n";
+    theme << "legend: { align: 'left', verticalAlign: 'top', floating: false, borderWidth: 0, y: 20 },\n";
+    theme << "xAxis: { title: { text: '" << (timed ? "Time since the first sample [ms]" : "Sample") << "' } },\n";
+    theme << "yAxis: { title: { text: 'Time [ns]' }, min: 0 },\n";
+    theme << "tooltip: { headerFormat: '{series.name}<br>', pointFormat: '" << (timed ? "{point.x:.3f}ms" : "#{point.x}") << ": {point.y:.3f}ns' },\n";
+    theme << "plotOptions: { scatter: { marker: { radius: 2 } } },\n";
+
+    theme << "series: [\n";
+
+    std::string comma = "";
+    for(auto& s : series){
+        auto step = (s.count + blocks - 1) / blocks;
+
+        auto x = [&](std::size_t i){
+            return timed ? (s.records[i].time - s.records[0].time) * 1000.0 : double(s.records[i].index);
+        };
+
+        theme << comma << "{\n";
+        theme << "name: '" << s.name << "',\n";
+        theme << "data: [";
+
+        std::string inner_comma = "";
+        for(std::size_t first = 0; first < s.count; first += step){
+            auto last = std::min(first + step, s.count);
+
+            std::size_t low = first;
+            std::size_t high = first;
+
+            for(std::size_t i = first; i < last; ++i){
+                low = s.records[i].duration < s.records[low].duration ? i : low;
+                high = s.records[i].duration > s.records[high].duration ? i : high;
+            }
+
+            theme << inner_comma << "[" << x(std::min(low, high)) << "," << s.records[std::min(low, high)].duration << "]";
+            inner_comma = ",";
+
+            if(low != high){
+                theme << ",[" << x(std::max(low, high)) << "," << s.records[std::max(low, high)].duration << "]";
+            }
+        }
+
+        theme << "]\n";
+        theme << "}\n";
+
+        comma = ",";
+    }
+
+    theme << "]\n";
+
+    end_graph(theme);
+    theme.after_graph();
+    ++id;
+}
+
 template<typename Theme>
 void generate_standard_page(const std::string& target_folder, const std::string& file, cpm::reports_data& data, const cpm::document_t& doc, const std::vector<cpm::document_cref>& documents, cxxopts::Options& options, bool one = false, bool section = false, const std::string& filter = ""){
+    materialize(doc);
+
     bool time_graphs = !options.count("disable-time") && documents.size() > 1;
     bool compiler_graphs = !options.count("disable-compiler") && data.compilers.size() > 1;
     bool configuration_graphs = !options.count("disable-configuration") && data.configurations.size() > 1;
@@ -1203,24 +3342,203 @@ void generate_standard_page(const std::string& target_folder, const std::string&
     if(!one || !section){
         for(const auto& result : doc["results"]){
             if(!one || filter == strip_tags(result["title"].GetString())){
-                theme.before_result(strip_tags(result["title"].GetString()), false, documents);
+                bool counters_graph = counters_enabled(theme, result["results"]);
+                bool threads_graph = has_member(result["results"], "threads");
+
+                std::vector<std::string> extras;
+
+                if(counters_graph){
+                    extras.push_back("Counters");
+                }
+
+                if(threads_graph){
+                    extras.push_back("Threads");
+                }
+
+                bool roofline_graph = has_member(result["results"], "intensity");
+
+                if(roofline_graph){
+                    extras.push_back("Roofline");
+                }
+
+                bool resources_graph = resources_enabled(theme, result["results"]);
+
+                if(resources_graph){
+                    extras.push_back("Resources");
+                }
+
+                bool system_graph = result.HasMember("system_time");
+
+                if(system_graph){
+                    extras.push_back("System");
+                }
+
+                bool histogram_graphs = has_member(result["results"], "histogram");
+
+                if(histogram_graphs){
+                    extras.push_back("Distribution");
+                    extras.push_back("Percentiles");
+                }
+
+                auto samples = size_samples(document_samples(theme, doc), result);
+
+                if(!samples.empty()){
+                    extras.push_back("Samples");
+                }
+
+                theme.before_result(strip_tags(result["title"].GetString()) + system_flags_str(result), false, documents, extras);
+
+                if(threads_graph){
+                    generate_scaling_graph(theme, id, result);
+                } else {
+                    generate_run_graph(theme, id, result, doc);
+                }
+
+                if(time_graphs){
+                    generate_time_graph(theme, id, result, documents);
+                }
+
+                if(compiler_graphs){
+                    generate_compiler_graph(theme, id, result, doc);
+                }
+
+                if(configuration_graphs){
+                    generate_configuration_graph(theme, id, result, doc);
+                }
+
+                if(summary_table){
+                    generate_summary_table(theme, result, doc);
+                }
+
+                if(counters_graph){
+                    generate_counters_graph(theme, id, result);
+                }
+
+                if(threads_graph){
+                    generate_threads_graph(theme, id, result);
+                }
+
+                if(roofline_graph){
+                    generate_roofline_graph(theme, id, result["title"].GetString(), {{strip_tags(result["title"].GetString()), &result["results"]}}, doc);
+                }
+
+                if(resources_graph){
+                    generate_resources_graph(theme, id, result);
+                }
+
+                if(system_graph){
+                    generate_system_graph(theme, id, result, result["title"].GetString());
+                }
+
+                if(histogram_graphs){
+                    generate_distribution_graph(theme, id, result["title"].GetString(), size_histograms(result));
+                    generate_spectrum_graph(theme, id, result["title"].GetString(), run_histograms(result, doc, documents, data.documents));
+                }
+
+                if(!samples.empty()){
+                    generate_samples_graph(theme, id, result["title"].GetString(), samples);
+                }
 
-                generate_run_graph(theme, id, result);
+                theme.after_result();
+            }
+        }
+    }
+
+    if(!one || section){
+        for(auto& section : doc["sections"]){
+            if(!one || filter == strip_tags(section["name"].GetString())){
+                bool counters_graph = !options.count("disable-counters") && section_has_counters(section);
+
+                std::vector<std::string> extras;
+
+                if(counters_graph){
+                    extras.push_back("IPC");
+                }
+
+                std::vector<std::pair<std::string, const rapidjson::Value*>> roofline;
+
+                for(auto& r : section["results"]){
+                    if(has_member(r["results"], "intensity")){
+                        roofline.emplace_back(strip_tags(r["name"].GetString()), &r["results"]);
+                    }
+                }
+
+                if(!roofline.empty()){
+                    extras.push_back("Roofline");
+                }
+
+                bool resources_graph = section_resources_enabled(theme, section);
+
+                if(resources_graph){
+                    extras.push_back("Resources");
+                }
+
+                bool system_graph = section.HasMember("system_time");
+
+                if(system_graph){
+                    extras.push_back("System");
+                }
+
+                auto histograms = section_histograms(section);
+
+                if(!histograms.empty()){
+                    extras.push_back("Distribution");
+                    extras.push_back("Percentiles");
+                }
+
+                auto samples = section_samples(document_samples(theme, doc), section);
+
+                if(!samples.empty()){
+                    extras.push_back("Samples");
+                }
+
+                theme.before_result(strip_tags(section["name"].GetString()) + system_flags_str(section), compiler_graphs, documents, extras);
+
+                if(section_has_threads(section)){
+                    generate_section_scaling_graph(theme, id, section);
+                } else {
+                    generate_section_run_graph(theme, id, section, doc);
+                }
 
                 if(time_graphs){
-                    generate_time_graph(theme, id, result, documents);
+                    generate_section_time_graph(theme, id, section, documents);
                 }
 
                 if(compiler_graphs){
-                    generate_compiler_graph(theme, id, result, doc);
+                    generate_section_compiler_graph(theme, id, section, doc);
                 }
 
                 if(configuration_graphs){
-                    generate_configuration_graph(theme, id, result, doc);
+                    generate_section_configuration_graph(theme, id, section, doc);
                 }
 
                 if(summary_table){
-                    generate_summary_table(theme, result, doc);
+                    generate_section_summary_table(theme, id, section, doc);
+                }
+
+                if(counters_graph){
+                    generate_section_counters_graph(theme, id, section);
+                }
+
+                if(!roofline.empty()){
+                    generate_roofline_graph(theme, id, section["name"].GetString(), roofline, doc);
+                }
+
+                if(resources_graph){
+                    generate_section_resources_graph(theme, id, section);
+                }
+
+                if(system_graph){
+                    generate_system_graph(theme, id, section, section["name"].GetString());
+                }
+
+                if(!histograms.empty()){
+                    generate_distribution_graph(theme, id, section["name"].GetString(), histograms);
+                    generate_spectrum_graph(theme, id, section["name"].GetString(), histograms);
+                }
+
+                if(!samples.empty()){
+                    generate_samples_graph(theme, id, section["name"].GetString(), samples);
                 }
 
                 theme.after_result();
@@ -1228,32 +3546,167 @@ void generate_standard_page(const std::string& target_folder, const std::string&
         }
     }
 
-    if(!one || section){
-        for(auto& section : doc["sections"]){
-            if(!one || filter == strip_tags(section["name"].GetString())){
-                theme.before_result(strip_tags(section["name"].GetString()), compiler_graphs, documents);
+    footer(theme);
+}
 
-                generate_section_run_graph(theme, id, section);
+//A change point found in the history of a measure
+struct change_row {
+    const cpm::document_t* doc;
+    std::string bench;
+    std::string series;
+    cpm::change_point change;
+};
+
+//A change of the fitted complexity between two runs
+struct complexity_change_row {
+    const cpm::document_t* doc;
+    std::string bench;
+    std::string series;
+    std::string before;
+    std::string after;
+};
+
+//List of the change points of every bench and section, for each compiler
+//and configuration, the most recent first
+template<typename Theme>
+void generate_changes_page(const std::string& target_folder, cpm::reports_data& data, cxxopts::Options& options){
+    std::ofstream stream(target_folder + "/changes.html");
 
-                if(time_graphs){
-                    generate_section_time_graph(theme, id, section, documents);
-                }
+    auto& base = data.documents.back();
 
-                if(compiler_graphs){
-                    generate_section_compiler_graph(theme, id, section, doc);
+    Theme theme(data, options, stream, base["compiler"].GetString(), base["configuration"].GetString());
+
+    std::vector<change_row> rows;
+    std::vector<complexity_change_row> complexity_rows;
+    std::set<std::pair<std::string, std::string>> done;
+
+    std::for_each(data.documents.rbegin(), data.documents.rend(), [&](cpm::document_t& d){
+        if(!done.insert({d["compiler"].GetString(), d["configuration"].GetString()}).second){
+            return;
+        }
+
+        auto documents = select_documents(data.documents, d);
+
+        materialize(d);
+
+        for(auto& result : d["results"]){
+            std::vector<std::pair<std::string, std::vector<history_point>>> series;
+
+            if(options.count("time-sizes")){
+                for(auto& r : result["results"]){
+                    series.emplace_back(r["size"].GetString(), bench_history(theme, result, r["size"].GetString(), documents));
                 }
+            } else {
+                auto& results = result["results"];
+                series.emplace_back(results[results.Size() - 1]["size"].GetString(), bench_history(theme, result, nullptr, documents));
+            }
 
-                if(configuration_graphs){
-                    generate_section_configuration_graph(theme, id, section, doc);
+            for(auto& s : series){
+                for(auto& change : history_changes(theme, s.second)){
+                    rows.push_back({s.second[change.index].doc, strip_tags(result["title"].GetString()), s.first, change});
                 }
+            }
 
-                if(summary_table){
-                    generate_section_summary_table(theme, id, section, doc);
+            auto complexities = bench_complexities(result, documents);
+
+            for(auto index : complexity_changes(complexities)){
+                complexity_rows.push_back({complexities[index].doc, strip_tags(result["title"].GetString()), "", complexities[index - 1].complexity, complexities[index].complexity});
+            }
+        }
+
+        for(auto& section : d["sections"]){
+            for(auto& r : section["results"]){
+                for(auto& s : section_series(theme, section, r, documents)){
+                    for(auto& change : history_changes(theme, s.second)){
+                        rows.push_back({s.second[change.index].doc, strip_tags(section["name"].GetString()), s.first, change});
+                    }
                 }
 
-                theme.after_result();
+                auto complexities = section_complexities(section, r, documents);
+
+                for(auto index : complexity_changes(complexities)){
+                    complexity_rows.push_back({complexities[index].doc, strip_tags(section["name"].GetString()), strip_tags(r["name"].GetString()), complexities[index - 1].complexity, complexities[index].complexity});
+                }
             }
         }
+    });
+
+    std::stable_sort(rows.begin(), rows.end(), [](const change_row& lhs, const change_row& rhs){
+        return (*lhs.doc)["timestamp"].GetInt() > (*rhs.doc)["timestamp"].GetInt();
+    });
+
+    std::stable_sort(complexity_rows.begin(), complexity_rows.end(), [](const complexity_change_row& lhs, const complexity_change_row& rhs){
+        return (*lhs.doc)["timestamp"].GetInt() > (*rhs.doc)["timestamp"].GetInt();
+    });
+
+    header(theme);
+
+    theme.before_information("Change points");
+    theme << "<li>" << rows.size() << " change points in " << data.documents.size() << " runs</li>\n";
+    theme << "<li>Minimum step: " << options["change-threshold"].as<double>() << "% of the " << statistic_name(theme) << "</li>\n";
+
+    if(!complexity_rows.empty()){
+        theme << "<li><strong>Warning</strong>: the fitted complexity changed " << complexity_rows.size() << " times</li>\n";
+    }
+    theme.after_information();
+
+    after_buttons(theme);
+
+    theme.before_result("History", false, {}, {});
+
+    theme << "<table class=\"table\">\n";
+    theme << "<tr><th>Date</th><th>Tag</th><th>Compiler</th><th>Configuration</th><th>Bench</th><th>Series</th><th>Before</th><th>After</th><th>Change</th></tr>\n";
+
+    for(auto& row : rows){
+        auto& doc = *row.doc;
+
+        theme << "<tr>\n";
+        theme.cell(doc["time"].GetString());
+        theme.cell(doc["tag"].GetString());
+        theme.cell(doc["compiler"].GetString());
+        theme.cell(doc["configuration"].GetString());
+        theme.cell(row.bench);
+        theme.cell(row.series);
+        theme.cell(history_value_str(theme, row.change.before));
+        theme.cell(history_value_str(theme, row.change.after));
+
+        if(is_slowdown(theme, row.change)){
+            theme.red_cell(relative_change_str(row.change));
+        } else {
+            theme.green_cell(relative_change_str(row.change));
+        }
+
+        theme << "</tr>\n";
+    }
+
+    theme << "</table>\n";
+
+    theme.after_result();
+
+    if(!complexity_rows.empty()){
+        theme.before_result("Complexity", false, {}, {});
+
+        theme << "<table class=\"table\">\n";
+        theme << "<tr><th>Date</th><th>Tag</th><th>Compiler</th><th>Configuration</th><th>Bench</th><th>Series</th><th>Before</th><th>After</th></tr>\n";
+
+        for(auto& row : complexity_rows){
+            auto& doc = *row.doc;
+
+            theme << "<tr>\n";
+            theme.cell(doc["time"].GetString());
+            theme.cell(doc["tag"].GetString());
+            theme.cell(doc["compiler"].GetString());
+            theme.cell(doc["configuration"].GetString());
+            theme.cell(row.bench);
+            theme.cell(row.series);
+            theme.cell(row.before);
+            theme.red_cell(row.after);
+            theme << "</tr>\n";
+        }
+
+        theme << "</table>\n";
+
+        theme.after_result();
     }
 
     footer(theme);
@@ -1269,26 +3722,27 @@ void generate_pages(const std::string& target_folder, cpm::reports_data& data, c
     if(options.count("pages")){
         //Generate pages for each (bench-section)/configuration/compiler
         std::for_each(data.documents.rbegin(), data.documents.rend(), [&](cpm::document_t& d){
-            for(const auto& result : d["results"]){
-                auto file = cpm::filify(d["compiler"].GetString(), d["configuration"].GetString(), std::string("bench_") + strip_tags(result["title"].GetString()));
+            //The names are in the index, the runs are only read for their pages
+            for(const auto& result : index_of(d).benches){
+                auto file = cpm::filify(d["compiler"].GetString(), d["configuration"].GetString(), std::string("bench_") + result.name);
                 if(!pages.count(file)){
-                    generate_standard_page<Theme>(target_folder, file, data, d, select_documents(data.documents, d), options, true, false, strip_tags(result["title"].GetString()));
+                    generate_standard_page<Theme>(target_folder, file, data, d, select_documents(data.documents, d), options, true, false, result.name);
 
                     if(pages.empty()){
-                        generate_standard_page<Theme>(target_folder, "index.html", data, d, select_documents(data.documents, d), options, true, false, strip_tags(result["title"].GetString()));
+                        generate_standard_page<Theme>(target_folder, "index.html", data, d, select_documents(data.documents, d), options, true, false, result.name);
                     }
 
                     pages.insert(file);
                 }
             }
 
-            for(const auto& section : d["sections"]){
-                auto file = cpm::filify(d["compiler"].GetString(), d["configuration"].GetString(), std::string("section_") + strip_tags(section["name"].GetString()));
+            for(const auto& section : index_of(d).sections){
+                auto file = cpm::filify(d["compiler"].GetString(), d["configuration"].GetString(), std::string("section_") + section.name);
                 if(!pages.count(file)){
-                    generate_standard_page<Theme>(target_folder, file, data, d, select_documents(data.documents, d), options, true, true, strip_tags(section["name"].GetString()));
+                    generate_standard_page<Theme>(target_folder, file, data, d, select_documents(data.documents, d), options, true, true, section.name);
 
                     if(pages.empty()){
-                        generate_standard_page<Theme>(target_folder, "index.html", data, d, select_documents(data.documents, d), options, true, true, strip_tags(section["name"].GetString()));
+                        generate_standard_page<Theme>(target_folder, "index.html", data, d, select_documents(data.documents, d), options, true, true, section.name);
                     }
 
                     pages.insert(file);
@@ -1308,12 +3762,385 @@ void generate_pages(const std::string& target_folder, cpm::reports_data& data, c
             }
         });
     }
+
+    if(!options.count("disable-changes") && !options.count("disable-time") && data.documents.size() > 1){
+        generate_changes_page<Theme>(target_folder, data, options);
+    }
+}
+
+//Compare mode: significance of the differences between two runs, for CI
+
+//A run to compare and its raw samples if they were saved
+struct compare_run {
+    cpm::document_t doc;
+    std::string folder;
+    std::unique_ptr<cpm::sample_file> samples;
+};
+
+//The run is either a results file or the last run of a results folder. With
+//a reference run, the last run of the folder is taken among the runs of the
+//same compiler and configuration
+bool read_compare_run(const std::string& path, compare_run& run, const cpm::document_t* reference = nullptr){
+    if(cpm::folder_exists(path)){
+        auto documents = read_folder(path);
+
+        if(documents.empty()){
+            return false;
+        }
+
+        auto relevant = reference ? select_documents(documents, *reference) : std::vector<cpm::document_cref>();
+
+        if(reference && relevant.empty()){
+            std::cout << "cpm: No run of " << path << " with the compiler and configuration of the baseline, using its last run" << std::endl;
+        }
+
+        if(relevant.empty()){
+            relevant.assign(documents.begin(), documents.end());
+        }
+
+        auto& last = std::max_element(relevant.begin(), relevant.end(),
+            [](const cpm::document_t& lhs, const cpm::document_t& rhs){ return lhs["timestamp"].GetInt() < rhs["timestamp"].GetInt(); })->get();
+
+        run.doc = std::move(documents[&last - documents.data()]);
+        run.folder = path;
+
+        materialize(run.doc);
+    } else {
+        auto slash = path.rfind('/');
+
+        run.folder = slash == std::string::npos ? std::string(".") : path.substr(0, slash);
+
+        auto file = slash == std::string::npos ? path : path.substr(slash + 1);
+
+        struct stat buffer;
+        if(stat(path.c_str(), &buffer)){
+            return false;
+        }
+
+        run.doc = read_document(run.folder, file);
+
+        if(run.doc.HasParseError()){
+            return false;
+        }
+    }
+
+    if(run.doc.HasMember("samples_file")){
+        run.samples = std::make_unique<cpm::sample_file>();
+
+        if(!run.samples->open(run.folder + "/" + run.doc["samples_file"].GetString())){
+            run.samples.reset();
+        }
+    }
+
+    return true;
+}
+
+std::vector<cpm::weighted_sample> raw_weighted(const compare_run& run, const char* group, const char* name, const char* size){
+    std::vector<cpm::weighted_sample> samples;
+
+    if(run.samples){
+        auto i = run.samples->find(group, name, size);
+
+        if(i < run.samples->series()){
+            auto records = run.samples->samples(i);
+
+            for(std::size_t j = 0; j < run.samples->count(i); ++j){
+                samples.push_back({records[j].duration, 1.0});
+            }
+        }
+    }
+
+    return samples;
+}
+
+std::vector<cpm::weighted_sample> histogram_weighted(json_value r){
+    std::vector<cpm::weighted_sample> samples;
+
+    for(auto& bucket : cpm::decode_histogram(r["histogram"].GetString())){
+        samples.push_back({(bucket.low + bucket.high) / 2.0, double(bucket.count)});
+    }
+
+    return samples;
+}
+
+struct comparison {
+    std::string name;
+    std::string size;
+    std::string test;
+    double baseline;
+    double candidate;
+    double change;      //relative change of the time, positive when slower
+    double p_value;     //negative if the test does not give one
+    double effect;
+    std::string effect_name;
+    bool significant;
+};
+
+//The rank test is used when the distributions are known, Welch's t-test
+//when only their moments are and the overlap of the confidence intervals
+//of the mean for older results. The raw samples of each run are found with
+//its own names, the names are only matched without their tags
+comparison compare_measures(const compare_run& base, json_value b, const char* base_group, const char* base_name,
+                            const compare_run& candidate, json_value c, const char* group, const char* name, double alpha){
+    comparison result;
+    result.size = c["size"].GetString();
+    result.p_value = -1.0;
+    result.effect = 0.0;
+
+    auto base_samples = raw_weighted(base, base_group, base_name, b["size"].GetString());
+    auto candidate_samples = raw_weighted(candidate, group, name, c["size"].GetString());
+
+    if(base_samples.empty() || candidate_samples.empty()){
+        result.test = "mann-whitney (histogram)";
+
+        if(b.HasMember("histogram") && c.HasMember("histogram")){
+            base_samples = histogram_weighted(b);
+            candidate_samples = histogram_weighted(c);
+        } else {
+            base_samples.clear();
+            candidate_samples.clear();
+        }
+    } else {
+        result.test = "mann-whitney (raw)";
+    }
+
+    if(!base_samples.empty() && !candidate_samples.empty()){
+        auto statistic = b.HasMember("median") && c.HasMember("median") ? "median" : "mean";
+
+        result.baseline = b[statistic].GetDouble();
+        result.candidate = c[statistic].GetDouble();
+
+        auto test = cpm::mann_whitney_test(base_samples, candidate_samples);
+
+        result.p_value = test.p_value;
+        result.effect = test.effect;
+        result.effect_name = "delta";
+        result.significant = test.p_value < alpha;
+    } else if(b.HasMember("samples") && c.HasMember("samples")){
+        result.test = "welch";
+        result.baseline = b["mean"].GetDouble();
+        result.candidate = c["mean"].GetDouble();
+
+        auto test = cpm::welch_test(
+            result.baseline, b["stddev"].GetDouble(), b["samples"].GetInt(),
+            result.candidate, c["stddev"].GetDouble(), c["samples"].GetInt());
+
+        result.p_value = test.p_value;
+        result.effect = test.effect;
+        result.effect_name = "d";
+        result.significant = test.p_value < alpha;
+    } else {
+        result.test = "ci-overlap";
+        result.baseline = b["mean"].GetDouble();
+        result.candidate = c["mean"].GetDouble();
+        result.significant = b["mean_ub"].GetDouble() < c["mean_lb"].GetDouble() || c["mean_ub"].GetDouble() < b["mean_lb"].GetDouble();
+    }
+
+    result.change = result.baseline == 0.0 ? 0.0 : result.candidate / result.baseline - 1.0;
+
+    return result;
+}
+
+const rapidjson::Value* find_by(json_value array, const char* attr, const char* value){
+    for(auto& v : array){
+        if(strip_equal(v[attr].GetString(), value)){
+            return &v;
+        }
+    }
+
+    return nullptr;
+}
+
+//Compare every measure of the candidate that is also in the baseline
+std::vector<comparison> compare_runs(const compare_run& base, const compare_run& candidate, double alpha){
+    std::vector<comparison> comparisons;
+
+    for(auto& result : candidate.doc["results"]){
+        auto* base_result = find_by(base.doc["results"], "title", result["title"].GetString());
+
+        if(!base_result){
+            continue;
+        }
+
+        for(auto& r : result["results"]){
+            auto* base_r = find_by((*base_result)["results"], "size", r["size"].GetString());
+
+            if(base_r){
+                comparisons.push_back(compare_measures(base, *base_r, (*base_result)["title"].GetString(), "", candidate, r, result["title"].GetString(), "", alpha));
+                comparisons.back().name = strip_tags(result["title"].GetString());
+            }
+        }
+    }
+
+    for(auto& section : candidate.doc["sections"]){
+        auto* base_section = find_by(base.doc["sections"], "name", section["name"].GetString());
+
+        if(!base_section){
+            continue;
+        }
+
+        for(auto& implementation : section["results"]){
+            auto* base_implementation = find_by((*base_section)["results"], "name", implementation["name"].GetString());
+
+            if(!base_implementation){
+                continue;
+            }
+
+            for(auto& r : implementation["results"]){
+                auto* base_r = find_by((*base_implementation)["results"], "size", r["size"].GetString());
+
+                if(base_r){
+                    comparisons.push_back(compare_measures(base, *base_r, (*base_section)["name"].GetString(), (*base_implementation)["name"].GetString(),
+                        candidate, r, section["name"].GetString(), implementation["name"].GetString(), alpha));
+                    comparisons.back().name = strip_tags(section["name"].GetString()) + "/" + implementation["name"].GetString();
+                }
+            }
+        }
+    }
+
+    return comparisons;
+}
+
+std::string change_str(double change){
+    return (change > 0.0 ? "+" : "") + cpm::to_string_precision(change * 100.0, 3) + "%";
+}
+
+//Ranked table of the comparisons, the ones above the threshold are marked
+void print_comparisons(const std::string& title, const std::vector<comparison>& comparisons, double threshold){
+    if(comparisons.empty()){
+        return;
+    }
+
+    std::vector<std::vector<std::string>> rows;
+    rows.push_back({"", "Benchmark", "Size", "Baseline", "Candidate", "Change", "Effect", "p", "Test"});
+
+    for(auto& c : comparisons){
+        rows.push_back({
+            std::abs(c.change) > threshold ? "!" : "",
+            c.name,
+            c.size,
+            cpm::duration_str(c.baseline, 4),
+            cpm::duration_str(c.candidate, 4),
+            change_str(c.change),
+            c.effect_name.empty() ? "-" : c.effect_name + "=" + cpm::to_string_precision(c.effect, 3),
+            c.p_value < 0.0 ? "-" : cpm::to_string_precision(c.p_value, 3),
+            c.test});
+    }
+
+    std::vector<std::size_t> widths(rows.front().size(), 0);
+
+    for(auto& row : rows){
+        for(std::size_t i = 0; i < row.size(); ++i){
+            widths[i] = std::max(widths[i], row[i].size());
+        }
+    }
+
+    std::cout << std::endl << title << " (" << comparisons.size() << ")" << std::endl;
+
+    for(auto& row : rows){
+        for(std::size_t i = 0; i < row.size(); ++i){
+            std::cout << std::left << std::setw(widths[i] + 2) << row[i];
+        }
+
+        std::cout << std::endl;
+    }
+}
+
+int compare_main(int argc, char* argv[]){
+    cxxopts::Options options(argv[0], "  baseline candidate");
+
+    try {
+        options.add_options()
+            ("threshold", "Relative slowdown [%] above which a significant regression fails the comparison", cxxopts::value<double>()->default_value("5"))
+            ("alpha", "Significance level of the tests", cxxopts::value<double>()->default_value("0.05"))
+            ("input", "Baseline and candidate results (file or folder)", cxxopts::value<std::vector<std::string>>())
+            ("h,help", "Print help")
+            ;
+
+        options.parse_positional("input");
+        options.parse(argc, argv);
+
+        if (options.count("help")){
+            std::cout << options.help({""}) << std::endl;
+            return 0;
+        }
+
+        if (options.count("input") != 2){
+            std::cout << "cpm: compare needs a baseline and a candidate, exiting" << std::endl;
+            return -1;
+        }
+    } catch (const cxxopts::OptionException& e){
+        std::cout << "cpm: error parsing options: " << e.what() << std::endl;
+        return -1;
+    }
+
+    auto& inputs = options["input"].as<std::vector<std::string>>();
+
+    compare_run base;
+    compare_run candidate;
+
+    if(!read_compare_run(inputs[0], base)){
+        std::cout << "cpm: Impossible to read the baseline " << inputs[0] << ", exiting" << std::endl;
+        return -1;
+    }
+
+    if(!read_compare_run(inputs[1], candidate, &base.doc)){
+        std::cout << "cpm: Impossible to read the candidate " << inputs[1] << ", exiting" << std::endl;
+        return -1;
+    }
+
+    if(!str_equal(base.doc["compiler"].GetString(), candidate.doc["compiler"].GetString()) || !str_equal(base.doc["configuration"].GetString(), candidate.doc["configuration"].GetString())){
+        std::cout << "cpm: The baseline and the candidate do not have the same compiler and configuration" << std::endl;
+    }
+
+    auto threshold = options["threshold"].as<double>() / 100.0;
+    auto alpha = options["alpha"].as<double>();
+
+    std::cout << "Baseline:  " << base.doc["tag"].GetString() << " (" << base.doc["compiler"].GetString() << ", " << base.doc["configuration"].GetString() << ")" << std::endl;
+    std::cout << "Candidate: " << candidate.doc["tag"].GetString() << " (" << candidate.doc["compiler"].GetString() << ", " << candidate.doc["configuration"].GetString() << ")" << std::endl;
+
+    auto comparisons = compare_runs(base, candidate, alpha);
+
+    std::vector<comparison> regressions;
+    std::vector<comparison> improvements;
+
+    for(auto& c : comparisons){
+        if(c.significant && c.change > 0.0){
+            regressions.push_back(c);
+        } else if(c.significant && c.change < 0.0){
+            improvements.push_back(c);
+        }
+    }
+
+    std::sort(regressions.begin(), regressions.end(), [](const comparison& lhs, const comparison& rhs){ return lhs.change > rhs.change; });
+    std::sort(improvements.begin(), improvements.end(), [](const comparison& lhs, const comparison& rhs){ return lhs.change < rhs.change; });
+
+    print_comparisons("Regressions", regressions, threshold);
+    print_comparisons("Improvements", improvements, threshold);
+
+    auto failed = std::count_if(regressions.begin(), regressions.end(), [threshold](const comparison& c){ return c.change > threshold; });
+
+    std::cout << std::endl << comparisons.size() << " measures compared: "
+        << regressions.size() << " significant regressions, "
+        << improvements.size() << " significant improvements, "
+        << (comparisons.size() - regressions.size() - improvements.size()) << " unchanged" << std::endl;
+
+    if(failed){
+        std::cout << "cpm: " << failed << " regressions above " << cpm::to_string_precision(threshold * 100.0, 3) << "%" << std::endl;
+        return 1;
+    }
+
+    return 0;
 }
 
 } //end of anonymous namespace
 
 int main(int argc, char* argv[]){
-    cxxopts::Options options(argv[0], "  results_folder");
+    if(argc > 1 && str_equal(argv[1], "compare")){
+        return compare_main(argc - 1, argv + 1);
+    }
+
+    cxxopts::Options options(argv[0], "  results_folder\n  compare baseline candidate");
 
     try {
         options.add_options()
@@ -1326,10 +4153,18 @@ int main(int argc, char* argv[]){
             ("p,pages", "General several HTML pages (one per bench/section)")
             ("m,mflops", "Use MFlops/s instead of E/s in summary")
             ("g,mflops-graphs", "Use MFlops/s instead of time in graphs")
+            ("statistic", "Statistic of the time in graphs and comparisons [mean,median,p90,p99,p999,min,max,stddev,mad,iqr]", cxxopts::value<std::string>()->default_value("mean"))
             ("d,disable-time", "Disable time graphs")
+            ("disable-changes", "Disable the detection of change points in the history")
+            ("change-threshold", "Minimum relative step [%] of a change point in the history", cxxopts::value<double>()->default_value("5"))
+            ("baseline", "Compare with the last run of this tag instead of the previous and first runs", cxxopts::value<std::string>(), "tag")
+            ("baseline-file", "Compare with the run of this results file instead of the previous and first runs", cxxopts::value<std::string>(), "file")
+            ("normalize", "Normalise the runs of different machines with their calibrated peak [flops,bandwidth]", cxxopts::value<std::string>(), "peak")
             ("disable-compiler", "Disable compiler graphs")
             ("disable-configuration", "Disable configuration graphs")
             ("disable-summary", "Disable summary table")
+            ("disable-counters", "Disable hardware counters columns and graphs")
+            ("disable-resources", "Disable the graphs of page faults, context switches and RSS")
             ("h,help", "Print help")
             ;
 
@@ -1345,6 +4180,16 @@ int main(int argc, char* argv[]){
             std::cout << "cpm: No input provided, exiting" << std::endl;
             return 0;
         }
+
+        if (!is_statistic(options["statistic"].as<std::string>())){
+            std::cout << "cpm: Unknown statistic \"" << options["statistic"].as<std::string>() << "\", exiting" << std::endl;
+            return -1;
+        }
+
+        if (options.count("normalize") && options["normalize"].as<std::string>() != "flops" && options["normalize"].as<std::string>() != "bandwidth"){
+            std::cout << "cpm: Unknown peak \"" << options["normalize"].as<std::string>() << "\", exiting" << std::endl;
+            return -1;
+        }
     } catch (const cxxopts::OptionException& e){
         std::cout << "cpm: error parsing options: " << e.what() << std::endl;
         return -1;
@@ -1374,6 +4219,36 @@ int main(int argc, char* argv[]){
         return -1;
     }
 
+    if(options.count("baseline-file")){
+        auto& file = options["baseline-file"].as<std::string>();
+
+        struct stat buffer;
+        if(stat(file.c_str(), &buffer)){
+            std::cout << "cpm: The baseline file does not exists, exiting" << std::endl;
+            return -1;
+        }
+
+        auto slash = file.rfind('/');
+
+        if(slash == std::string::npos){
+            data.baselines.push_back(read_document(".", file));
+        } else {
+            data.baselines.push_back(read_document(file.substr(0, slash), file.substr(slash + 1)));
+        }
+
+        if(data.baselines.back().HasParseError()){
+            std::cout << "cpm: Impossible to read the baseline file, exiting" << std::endl;
+            return -1;
+        }
+    } else if(options.count("baseline")){
+        auto& tag = options["baseline"].as<std::string>();
+
+        if(std::none_of(data.documents.begin(), data.documents.end(), [&tag](cpm::document_t& doc){ return tag == doc["tag"].GetString(); })){
+            std::cout << "cpm: No run with the baseline tag \"" << tag << "\", exiting" << std::endl;
+            return -1;
+        }
+    }
+
     //Collect the list of compilers
     for(auto& doc : data.documents){
         data.compilers.insert(doc["compiler"].GetString());
@@ -0,0 +1,66 @@
+//=======================================================================
+// Copyright (c) 2015-2016 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+#include "cpm/samples.hpp"
+
+//List the series of a raw samples file or print the samples of one of them as CSV
+
+int main(int argc, char* argv[]){
+    if(argc < 2 || argc > 3){
+        std::cout << "Usage: " << argv[0] << " file.samples [series]" << std::endl;
+        return -1;
+    }
+
+    cpm::sample_file file;
+
+    if(!file.open(argv[1])){
+        std::cout << "cpm_samples: Impossible to read " << argv[1] << std::endl;
+        return -1;
+    }
+
+    if(argc == 2){
+        for(std::size_t i = 0; i < file.series(); ++i){
+            std::cout << i << ": " << file.group(i);
+
+            if(!file.name(i).empty()){
+                std::cout << " / " << file.name(i);
+            }
+
+            std::cout << " (" << file.size(i) << ") " << file.count(i) << " samples" << std::endl;
+        }
+
+        return 0;
+    }
+
+    std::size_t i = 0;
+
+    try {
+        i = std::stoul(argv[2]);
+    } catch (const std::exception&){
+        i = file.series();
+    }
+
+    if(i >= file.series()){
+        std::cout << "cpm_samples: Invalid series " << argv[2] << std::endl;
+        return -1;
+    }
+
+    auto samples = file.samples(i);
+
+    std::cout << std::setprecision(12);
+    std::cout << "index,time,duration" << std::endl;
+
+    for(std::size_t j = 0; j < file.count(i); ++j){
+        std::cout << samples[j].index << "," << samples[j].time << "," << samples[j].duration << "\n";
+    }
+
+    return 0;
+}